@@ -0,0 +1,34 @@
+#ifndef TA_ASSET_PACK_H
+#define TA_ASSET_PACK_H
+
+#include <cstdint>
+#include <string_view>
+
+// Optional single-file archive of the assets directory, written by tools/pack_assets.cpp on install.
+// Layout: header, index sorted by name, names, then file data aligned to dataAlignment.
+
+struct TA_AssetPackHeader {
+    char magic[4];
+    uint32_t version, count, reserved;
+};
+
+struct TA_AssetPackEntry {
+    uint32_t nameOffset, nameLength;
+    uint64_t dataOffset, dataSize;
+};
+
+namespace TA::assetPack {
+    constexpr char magic[4] = {'T', 'A', 'P', 'K'};
+    constexpr uint32_t version = 1;
+    constexpr uint64_t dataAlignment = 16;
+
+    // maps assets.pak next to the assets directory if it exists, unless --loose-assets or --bake-levels is given;
+    // loose files newer than the pack are read instead of their packed copies
+    void init();
+    bool isOpen();
+    // contents of an asset in the pack, empty if it isn't packed; valid until quit
+    std::string_view getAsset(std::string_view filename);
+    void quit();
+}
+
+#endif // TA_ASSET_PACK_H
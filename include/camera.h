@@ -2,6 +2,7 @@
 #define TA_CAMERA_H
 
 #include "geometry.h"
+#include "state_buffer.h"
 
 class TA_Camera {
 private:
@@ -11,7 +12,8 @@ private:
 
     void updateOffset();
 
-    TA_Point position, lockPosition, shakeDelta;
+    TA_Point position, lockPosition, shakeDelta, previousPosition;
+    long long updateTick = -1;
     TA_Point *followPosition;
     TA_Rect border;
 
@@ -29,7 +31,9 @@ public:
     void setBorder(TA_Rect newBorder) {border = newBorder;}
     void shake(double time) {shakeTime = time;}
     TA_Point getPosition() {return position + shakeDelta;}
+    TA_Point getDrawPosition();
     TA_Point getRelative(TA_Point realPosition) {return realPosition - (position + shakeDelta);}
+    void serialize(TA_StateBuffer &buffer);
 };
 
 
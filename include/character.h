@@ -7,6 +7,7 @@
 #include "links.h"
 #include "tilemap.h"
 #include "sound.h"
+#include "save.h"
 
 class TA_Character : public TA_Pawn {
 private:
@@ -66,6 +67,7 @@ private:
     const double waterFriction = 0.75;
     const double waterFlowAcc = 0.15;
     const double maxCoyoteTime = 10;
+    const double collisionContextMargin = 48;
 
     TA_Point followPosition, velocity, climbPosition;
     TA_Links links;
@@ -80,6 +82,15 @@ private:
     CharacterState state = STATE_NORMAL;
 
     TA_Sprite remoteRobotControlSprite;
+
+    // animations picked every frame, resolved once in load
+    struct AnimationIds {
+        int idle, walk, push, lookUp, crouch, hurt, fall;
+        int jumpUp, jumpDown;
+        int helitail, helitailFull, helitailTired;
+        int throwHelitail, throwAir, release;
+        int remoteRobotIdle, remoteRobotWalk, remoteRobotFlyLoop;
+    } animationIds;
     TA_Point remoteRobotInitialPosition;
 
     bool ground = false, helitail = false, wall = false, ceiling = false, flip = false;
@@ -99,6 +110,7 @@ private:
     double coyoteTime = 0;
     double deltaX = 0;
     int rings, currentTool = TOOL_BOMB;
+    const TA_SaveParameterHandle ringsParameter = TA::save::getSaveParameterHandle("rings");
     bool usingSpeedBoots = false;
 
     void physicsStep();
@@ -111,7 +123,11 @@ private:
     void updateFollowPosition();
     void horizontalMove();
     bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override;
+    void addCollisionCandidates(TA_Rect bounds, std::vector<TA_CollisionHitbox> &candidates) override;
     void updateCollisions();
+    TA_Rect getCollisionContextBounds();
+    void loadAnimationIds();
     void updateAnimation();
     void updateClimb();
     void updateClimbAnimation();
@@ -162,7 +178,7 @@ public:
     bool isUsingSpeedBoots() {return usingSpeedBoots;}
     bool isUsingHammer() {return state == STATE_HAMMER;}
     bool isInWater() {return water;}
-    bool isGettingItem() {return state == STATE_UNPACK_ITEM || state == STATE_RAISE_ITEM || getAnimationName() == "release";}
+    bool isGettingItem() {return state == STATE_UNPACK_ITEM || state == STATE_RAISE_ITEM || isPlayingAnimation(animationIds.release);}
 
     void setUnpackState() {state = STATE_UNPACK_ITEM;}
     void setRaiseState();
@@ -174,6 +190,7 @@ public:
     void resetInstaShield();
     void setWindVelocity(TA_Point windVelocity);
     void setPaused(bool paused);
+    void serialize(TA_StateBuffer &buffer) override;
 };
 
 #endif // TA_CHARACTER_H
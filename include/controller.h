@@ -44,6 +44,7 @@ private:
     TA_Sprite stickSprite, pointerSprite;
     TA_OnscreenStick stick;
     TA_Point vector;
+    bool rewindButton = false; // rewind_seconds read once in load
 
 public:
     void load();
@@ -59,7 +60,7 @@ public:
 
 class TA_Controller {
 private:
-    const double analogDeadZone = 0.25;
+    static constexpr double analogDeadZone = 0.25;
     const double verticalRange = 30;
 
     TA_GamepadController gamepad;
@@ -83,6 +84,11 @@ public:
     bool isJustPressed(TA_FunctionButton button);
     bool isJustChangedDirection() {return justChanged;}
     bool isTouchscreen();
+    void serialize(TA_StateBuffer &buffer) {buffer.sync(currentDirection, justChanged);}
+
+    // keyboard and gamepad state of the current step, this is what TA::eventLog records
+    // (onscreen touch input is not, so logging is refused on Android)
+    static TA_InputState getDeviceInput();
 };
 
 #endif // TA_CONTROLLER_H
@@ -2,6 +2,7 @@
 #define TA_FILESYSTEM_H
 
 #include <string>
+#include <string_view>
 
 namespace TA::filesystem {
     void fixPath(std::string &path);
@@ -13,4 +14,22 @@ namespace TA::filesystem {
     void writeFile(std::string path, std::string value);
 }
 
+// Read-only view of a whole file: memory mapped on desktop, read into memory on Android
+class TA_MappedFile {
+private:
+    std::string_view data;
+    std::string buffer;
+    void *mapping = nullptr, *mappingHandle = nullptr;
+
+public:
+    TA_MappedFile() = default;
+    TA_MappedFile(const TA_MappedFile&) = delete;
+    TA_MappedFile& operator=(const TA_MappedFile&) = delete;
+    ~TA_MappedFile() {close();}
+
+    bool open(std::string path);
+    void close();
+    std::string_view getData() const {return data;}
+};
+
 #endif // TA_FILESYSTEM_H
@@ -5,6 +5,7 @@
 #include "SDL3/SDL.h"
 #include "screen_state_machine.h"
 #include "font.h"
+#include "save.h"
 
 class TA_Game {
 private:
@@ -18,17 +19,29 @@ private:
     void createWindow();
     void toggleFullscreen();
     void updateWindowSize();
+    void updateVSync();
+    bool step(double elapsedTime);
 
-    std::chrono::time_point<std::chrono::high_resolution_clock> startTime, currentTime;
+    std::chrono::time_point<std::chrono::high_resolution_clock> startTime, currentTime, simulationStartTime;
     TA_ScreenStateMachine screenStateMachine;
 
     SDL_Texture *targetTexture = nullptr;
+    SDL_Surface *headlessSurface = nullptr;
 
     int windowWidth, windowHeight, targetWidth = 0, targetHeight = 0;
-    bool vsync = false, fullscreen = true;
+    double accumulator = 0;
+    bool vsync = false, fullscreen = true, quitNeeded = false;
+
+    const TA_ParameterHandle pixelARParameter = TA::save::getParameterHandle("pixel_ar");
+    const TA_ParameterHandle resolutionParameter = TA::save::getParameterHandle("resolution");
+    const TA_ParameterHandle scaleModeParameter = TA::save::getParameterHandle("scale_mode");
+    const TA_ParameterHandle frameTimeParameter = TA::save::getParameterHandle("frame_time");
+    const TA_ParameterHandle vsyncParameter = TA::save::getParameterHandle("vsync");
 
     TA_Font font;
     int frame = 0, frameTimeSum = 0, prevFrameTime = 0;
+    long long prevAvoidedQueries = 0, avoidedQueriesPerFrame = 0;
+    long long prevCaptureTime = 0, captureTimePerFrame = 0;
 
 public:
     TA_Game();
@@ -11,6 +11,9 @@
 #include "links.h"
 #include "hud.h"
 #include "object_set.h"
+#include "save.h"
+#include "state_buffer.h"
+#include "rewind_buffer.h"
 
 class TA_GameScreen : public TA_Screen {
 private:
@@ -23,13 +26,27 @@ private:
     TA_Links links;
     TA_Hud hud;
 
-    bool isSeaFox = false;
+    bool isSeaFox = false, checkingSnapshots = false;
     double timer = 0;
+    const TA_SaveParameterHandle timeParameter = TA::save::getSaveParameterHandle("time");
+    TA_Snapshot checkSnapshots[2];
+    TA_RewindBuffer rewindBuffer;
+    TA_Snapshot rewindSnapshot;
+
+    void serialize(TA_Snapshot &snapshot);
+    void checkSnapshot();
+    bool updateRewind();
 
 public:
     void init() override;
     TA_ScreenState update() override;
+    bool isFixedStep() override {return true;}
+    void draw() override;
     void quit() override;
+
+    // the whole level state between two steps, restoring it continues exactly from there
+    void saveState(TA_Snapshot &snapshot);
+    void loadState(TA_Snapshot &snapshot);
 };
 
 
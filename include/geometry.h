@@ -1,9 +1,12 @@
 #ifndef TA_GEOMETRY_H
 #define TA_GEOMETRY_H
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <limits>
 
 namespace TA {
     constexpr double epsilon = 1e-5;
@@ -83,6 +86,9 @@ private:
 
 class TA_Polygon {
 public:
+    // vertices are stored inline, so polygons can be created and moved around without heap allocations
+    static constexpr size_t maxVertices = 8;
+
     TA_Polygon() = default;
 
     TA_Polygon(const TA_Point& topLeft, const TA_Point& bottomRight) {
@@ -90,12 +96,13 @@ public:
     }
 
     void setRectangle(const TA_Point& topLeft, const TA_Point& bottomRight) {
-        sourceVertexList.clear();
-        sourceVertexList.emplace_back(topLeft);
-        sourceVertexList.emplace_back(bottomRight.x, topLeft.y);
-        sourceVertexList.emplace_back(bottomRight);
-        sourceVertexList.emplace_back(topLeft.x, bottomRight.y);
+        sourceVertexList[0] = topLeft;
+        sourceVertexList[1] = {bottomRight.x, topLeft.y};
+        sourceVertexList[2] = bottomRight;
+        sourceVertexList[3] = {topLeft.x, bottomRight.y};
+        vertexCount = 4;
         rect = true;
+        updateNormalList();
         updateVertexList();
     }
 
@@ -106,11 +113,32 @@ public:
 
     [[nodiscard]] const TA_Point& getPosition() const {return position;}
 
+    // loaders check the vertex count with TA::handleError, extra vertices are dropped here
     void addVertex(const TA_Point& vertex) {
-        sourceVertexList.push_back(vertex);
-        updateVertexList();
+        assert(vertexCount < maxVertices);
+        if(vertexCount >= maxVertices) [[unlikely]] {
+            return;
+        }
 
-        rect = (vertexList.size() == 4 &&
+        // only the last edge and the new closing edge change, so a polygon is built in O(n)
+        const size_t pos = vertexCount;
+        sourceVertexList[pos] = vertex;
+        vertexList[pos] = vertex + position;
+        vertexCount += 1;
+        updateNormal(pos == 0 ? 0 : pos - 1);
+        updateNormal(pos);
+
+        if(pos == 0) {
+            boundsTopLeft = boundsBottomRight = vertexList[0];
+        }
+        else {
+            boundsTopLeft.x = std::min(boundsTopLeft.x, vertexList[pos].x);
+            boundsTopLeft.y = std::min(boundsTopLeft.y, vertexList[pos].y);
+            boundsBottomRight.x = std::max(boundsBottomRight.x, vertexList[pos].x);
+            boundsBottomRight.y = std::max(boundsBottomRight.y, vertexList[pos].y);
+        }
+
+        rect = (vertexCount == 4 &&
             TA::equal(getVertex(1).x, getVertex(2).x) &&
             TA::equal(getVertex(1).y, getVertex(0).y) &&
             TA::equal(getVertex(3).x, getVertex(0).x) &&
@@ -123,49 +151,122 @@ public:
                    getTopLeft().y <= point.y && point.y <= getBottomRight().y;
         }
 
-        const TA_Line ray{point, {1e5, point.y}};
-        int count = 0;
-
-        for(size_t pos = 0; pos < vertexList.size(); pos += 1) {
-            const TA_Line currentLine{vertexList[pos], vertexList[(pos + 1) % vertexList.size()]};
-            if(ray.intersects(currentLine)) {
-                count += 1;
+        // crossings of a ray to the right, each edge holds its lower end only, so a ray through a vertex counts once
+        bool result = false;
+        for(size_t pos = 0; pos < vertexCount; pos += 1) {
+            const TA_Point& first = vertexList[pos];
+            const TA_Point& second = vertexList[(pos + 1) % vertexCount];
+            if((first.y > point.y) != (second.y > point.y)) {
+                const double cross = (second.x - first.x) * (point.y - first.y) - (point.x - first.x) * (second.y - first.y);
+                if((cross > 0) == (second.y > first.y)) {
+                    result = !result;
+                }
             }
         }
-
-        return count % 2 == 1;
+        return result;
     }
 
     [[nodiscard]] bool intersects(const TA_Polygon& rv) const {
+        return intersects(rv, {0, 0});
+    }
+
+    // same as testing against a copy of rv moved by offset, e.g. a tile hitbox stored at the origin
+    [[nodiscard]] bool intersects(const TA_Polygon& rv, const TA_Point& offset) const {
         if(empty() || rv.empty()) [[unlikely]] {
             return false;
         }
 
         if(isRectangle() && rv.isRectangle()) [[likely]] {
-            return getTopLeft().x < rv.getBottomRight().x && getBottomRight().x > rv.getTopLeft().x &&
-                   getTopLeft().y < rv.getBottomRight().y && getBottomRight().y > rv.getTopLeft().y;
+            return getTopLeft().x < rv.getBottomRight().x + offset.x && getBottomRight().x > rv.getTopLeft().x + offset.x &&
+                   getTopLeft().y < rv.getBottomRight().y + offset.y && getBottomRight().y > rv.getTopLeft().y + offset.y;
+        }
+
+        // disjoint bounds mean disjoint polygons, so this only skips projecting on every axis
+        if(boundsTopLeft.x > rv.boundsBottomRight.x + offset.x || boundsBottomRight.x < rv.boundsTopLeft.x + offset.x ||
+            boundsTopLeft.y > rv.boundsBottomRight.y + offset.y || boundsBottomRight.y < rv.boundsTopLeft.y + offset.y) {
+            return false;
         }
 
-        for(int pos1 = 0; pos1 < size(); pos1 ++) {
-            const TA_Line line1 = {getVertex(pos1), getVertex((pos1 + 1) % size())};
-            for(int pos2 = 0; pos2 < rv.size(); pos2 ++) {
-                const TA_Line line2 = {rv.getVertex(pos2), rv.getVertex((pos2 + 1) % rv.size())};
-                if(line1.intersects(line2)) {
+        // separating axis test, polygons are convex; touching polygons intersect
+        auto separated = [&](const TA_Polygon& polygon) {
+            for(size_t pos = 0; pos < polygon.vertexCount; pos += 1) {
+                const TA_Point& axis = polygon.normalList[pos];
+                const double shift = offset.x * axis.x + offset.y * axis.y;
+                const Projection first = project(axis), second = rv.project(axis);
+                if(first.max < second.min + shift || second.max + shift < first.min) {
                     return true;
                 }
             }
+            return false;
+        };
+        return !separated(*this) && !separated(rv);
+    }
+
+    // returns true if polygons overlap with positive depth, mtv is the shortest shift of this polygon which separates them
+    [[nodiscard]] bool getPenetration(const TA_Polygon& rv, TA_Point& mtv) const {
+        if(empty() || rv.empty()) [[unlikely]] {
+            return false;
         }
 
-        if(rv.inside(getVertex(0))) {
+        double minDepth = -1;
+        auto testAxes = [&](const TA_Polygon& polygon) {
+            for(size_t pos = 0; pos < polygon.vertexCount; pos += 1) {
+                const TA_Point& normal = polygon.normalList[pos];
+                const double length = normal.length();
+                if(length == 0) [[unlikely]] {
+                    continue;
+                }
+                const Projection first = project(normal), second = rv.project(normal);
+                const double forward = second.max - first.min, backward = first.max - second.min;
+                if(forward <= 0 || backward <= 0) {
+                    return false;
+                }
+                const double depth = std::min(forward, backward) / length;
+                if(minDepth < 0 || depth < minDepth) {
+                    minDepth = depth;
+                    mtv = normal * ((forward < backward ? depth : -depth) / length);
+                }
+            }
             return true;
+        };
+        return testAxes(*this) && testAxes(rv);
+    }
+
+    // factors t for which this polygon moved by delta * t intersects rv, from the same axes as intersects;
+    // the ends are touching positions, which only intersect if either polygon isn't a rectangle
+    [[nodiscard]] bool getSweepInterval(const TA_Polygon& rv, const TA_Point& delta, double& enter, double& exit) const {
+        if(empty() || rv.empty()) [[unlikely]] {
+            return false;
         }
-        if(inside(rv.getVertex(0))) {
+
+        // like in intersects, touching rectangles don't intersect
+        const bool rectangles = isRectangle() && rv.isRectangle();
+        enter = -std::numeric_limits<double>::infinity();
+        exit = std::numeric_limits<double>::infinity();
+        auto testAxes = [&](const TA_Polygon& polygon) {
+            for(size_t pos = 0; pos < polygon.vertexCount; pos += 1) {
+                const TA_Point& normal = polygon.normalList[pos];
+                const Projection first = project(normal), second = rv.project(normal);
+                const double speed = delta.x * normal.x + delta.y * normal.y;
+                const double low = second.min - first.max, high = second.max - first.min;
+                if(speed == 0) {
+                    if(rectangles ? (low >= 0 || high <= 0) : (low > 0 || high < 0)) {
+                        return false;
+                    }
+                    continue;
+                }
+                enter = std::max(enter, (speed > 0 ? low : high) / speed);
+                exit = std::min(exit, (speed > 0 ? high : low) / speed);
+                if(rectangles ? enter >= exit : enter > exit) {
+                    return false;
+                }
+            }
             return true;
-        }
-        return false;
+        };
+        return testAxes(*this) && testAxes(rv);
     }
 
-    [[nodiscard]] size_t size() const {return vertexList.size();}
+    [[nodiscard]] size_t size() const {return vertexCount;}
     [[nodiscard]] bool empty() const {return size() == 0;}
     [[nodiscard]] bool isRectangle() const {return rect;}
 
@@ -178,17 +279,55 @@ public:
     [[nodiscard]] const TA_Point& getBottomRight() const {
         return getVertex(2);
     }
+    [[nodiscard]] const TA_Point& getBoundsTopLeft() const {return boundsTopLeft;}
+    [[nodiscard]] const TA_Point& getBoundsBottomRight() const {return boundsBottomRight;}
 
 private:
-    std::vector<TA_Point> vertexList;
-    std::vector<TA_Point> sourceVertexList;
-    TA_Point position;
+    struct Projection {
+        double min, max;
+    };
+
+    std::array<TA_Point, maxVertices> vertexList;
+    std::array<TA_Point, maxVertices> sourceVertexList;
+    std::array<TA_Point, maxVertices> normalList;
+    size_t vertexCount = 0;
+    TA_Point position, boundsTopLeft, boundsBottomRight;
     bool rect = false;
 
+    [[nodiscard]] Projection project(const TA_Point& axis) const {
+        Projection projection;
+        projection.min = projection.max = vertexList[0].x * axis.x + vertexList[0].y * axis.y;
+        for(size_t pos = 1; pos < vertexCount; pos += 1) {
+            const double value = vertexList[pos].x * axis.x + vertexList[pos].y * axis.y;
+            projection.min = std::min(projection.min, value);
+            projection.max = std::max(projection.max, value);
+        }
+        return projection;
+    }
+
+    // edge normals don't depend on position, so they are only updated when the shape changes;
+    // they are not normalized, which keeps projections of integer coordinates exact
+    void updateNormalList() {
+        for(size_t pos = 0; pos < vertexCount; pos += 1) {
+            updateNormal(pos);
+        }
+    }
+
+    void updateNormal(size_t pos) {
+        const TA_Point edge = sourceVertexList[(pos + 1) % vertexCount] - sourceVertexList[pos];
+        normalList[pos] = {edge.y, -edge.x};
+    }
+
     void updateVertexList() {
-        vertexList = sourceVertexList;
-        for(TA_Point& vertex : vertexList) {
-            vertex = vertex + position;
+        for(size_t pos = 0; pos < vertexCount; pos += 1) {
+            vertexList[pos] = sourceVertexList[pos] + position;
+        }
+        boundsTopLeft = boundsBottomRight = vertexList[0];
+        for(size_t pos = 1; pos < vertexCount; pos += 1) {
+            boundsTopLeft.x = std::min(boundsTopLeft.x, vertexList[pos].x);
+            boundsTopLeft.y = std::min(boundsTopLeft.y, vertexList[pos].y);
+            boundsBottomRight.x = std::max(boundsBottomRight.x, vertexList[pos].x);
+            boundsBottomRight.y = std::max(boundsBottomRight.y, vertexList[pos].y);
         }
     }
 };
@@ -1,36 +1,65 @@
 #ifndef TA_HITBOX_CONTAINER_H
 #define TA_HITBOX_CONTAINER_H
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include "geometry.h"
 #include "tilemap.h"
 
 class TA_HitboxContainer {
 private:
-    static const int size = 1e4, chunkSize = 128;
-    static const int sizeChunks = (size + chunkSize - 1) / chunkSize;
+    static const int defaultChunkSize = 128;
 
     struct Element {
-        TA_Polygon *hitbox;
-        int type;
+        TA_Polygon *hitbox = nullptr;
+        int type = TA_COLLISION_TRANSPARENT;
+        uint32_t queryTime = 0;
+    };
+
+    struct StaticElement : Element {
+        int left = 0, top = 0, right = -1, bottom = -1;
     };
 
     struct Chunk {
-        std::vector<Element> elements;
+        std::vector<int> elements;
         int updateTime = 0;
+        int typeMask = 0; // union of element types, chunks without requested types are skipped
     };
 
-    std::array<std::array<Chunk, sizeChunks>, sizeChunks> chunks;
-    Chunk commonChunk;
-    int currentTime = 0, collisionTypeMask = 0;
+    // dynamic layer is rebuilt every frame, static layer persists until entries are removed
+    std::vector<Element> elements;
+    std::vector<StaticElement> staticElements;
+    std::vector<Chunk> chunks, staticChunks;
+    std::vector<int> freeStaticElements;
+    std::array<int, 32> staticTypeCounts{}; // static elements with each type bit, they make up staticCollisionTypeMask
+    int width = 1, height = 1, chunkSize = defaultChunkSize;
+    int currentTime = 0, collisionTypeMask = 0, staticCollisionTypeMask = 0;
+    uint32_t queryTime = 0; // stamps elements visited by the current query, stamps are cleared when it wraps
 
     void lazyClear(Chunk &chunk);
+    void countStaticType(int type, int add);
+    void getChunkRange(TA_Point topLeft, TA_Point bottomRight, int &left, int &top, int &right, int &bottom);
+
+    // calls function once for every element with a type from mask in the chunks covering given area,
+    // stops when function returns false
+    template<typename Function>
+    void forEachElement(TA_Point topLeft, TA_Point bottomRight, int mask, Function function);
 
 public:
+    TA_HitboxContainer() {chunks.resize(1); staticChunks.resize(1);}
+    void setSize(int newWidth, int newHeight, int newChunkSize = defaultChunkSize);
     void add(TA_Polygon &hitbox, int type);
-    int getCollisionFlags(TA_Polygon &hitbox);
-    bool hasCollisionType(TA_CollisionType type) {return collisionTypeMask & type;}
+    int getCollisionFlags(TA_Polygon &hitbox) {return getCollisionFlags(hitbox, -1);}
+    int getCollisionFlags(TA_Polygon &hitbox, int mask);
+    void addCollisionCandidates(TA_Rect bounds, int mask, std::vector<TA_CollisionHitbox> &candidates);
+    bool hasCollisionType(int type) {return (collisionTypeMask | staticCollisionTypeMask) & type;}
     void clear();
+
+    // hitbox must not move while it is in the static layer; returns -1 for transparent hitboxes
+    int addStatic(TA_Polygon &hitbox, int type);
+    void removeStatic(int id);
+    int getStaticType(int id) {return id == -1 ? TA_COLLISION_TRANSPARENT : staticElements[id].type;}
 };
 
 #endif // TA_HITBOX_CONTAINER_H
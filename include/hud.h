@@ -9,6 +9,7 @@
 #include "sound.h"
 #include "screen.h"
 #include "touchscreen.h"
+#include "save.h"
 
 class TA_Hud {
 private:
@@ -22,6 +23,8 @@ private:
     std::array<TA_Sprite, 2> ringDigits;
     TA_Sound switchSound, itemSwitchSound, pauseSound;
     int item = 0, itemPosition = 0, rings = 0;
+    TA_SaveParameterHandle ringsParameter, itemPositionParameter;
+    std::array<TA_SaveParameterHandle, 4> itemSlotParameters;
     double flightBarX = flightBarLeft;
     double timer = 0;
 
@@ -50,6 +53,8 @@ public:
     [[nodiscard]] int getCurrentItem() const {return item;}
     [[nodiscard]] bool isPaused() const {return paused;}
     [[nodiscard]] TA_ScreenState getTransition() const {return transition;}
+    // the pause menu isn't game state and stays as it is
+    void serialize(TA_StateBuffer &buffer) {buffer.sync(item, itemPosition, rings, flightBarX, timer, transition);}
 };
 
 #endif // TA_HUD_H
@@ -0,0 +1,64 @@
+#ifndef TA_LEVEL_FILE_H
+#define TA_LEVEL_FILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "filesystem.h"
+
+// Compiled level: tilemap and object spawn records baked from a .tmx and .xml pair with --bake-levels
+class TA_LevelFile {
+private:
+    TA_MappedFile file;
+    std::string_view data;
+    size_t offset = 0;
+    bool failed = false;
+
+    void close();
+
+public:
+    static constexpr char magic[4] = {'T', 'A', 'L', 'V'};
+    static constexpr int32_t version = 4;
+
+    TA_LevelFile() = default;
+    TA_LevelFile(const TA_LevelFile&) = delete;
+    TA_LevelFile& operator=(const TA_LevelFile&) = delete;
+    ~TA_LevelFile();
+
+    // sizes and modification times of the loose .tmx and .xml of a level, zero for missing files;
+    // stored in the header to detect stale level files without reading the sources
+    static std::array<int64_t, 4> getSourceStamp(const std::string &levelPath);
+
+    // opens levelPath.bin, returns false if it doesn't exist, was baked for another version
+    // or its loose sources changed since; packed level files and levels shipped without sources aren't checked
+    bool open(const std::string &levelPath);
+    int32_t readInt();
+    double readDouble();
+    std::string readString();
+    // pointer into the file, valid while it is open; nullptr when reading past the end
+    const void* readBytes(size_t count);
+    void setFailed() {failed = true;}
+    bool isFailed() const {return failed;}
+};
+
+class TA_LevelFileWriter {
+private:
+    std::string data;
+
+public:
+    explicit TA_LevelFileWriter(const std::string &levelPath);
+    void writeInt(int32_t value);
+    void writeDouble(double value);
+    void writeString(const std::string &value);
+    void writeBytes(const void *bytes, size_t count);
+    void save(std::string filename);
+};
+
+namespace TA::levelFile {
+    // writes .bin next to every map in assets/maps and prints load times of both formats
+    void bakeLevels();
+}
+
+#endif // TA_LEVEL_FILE_H
@@ -0,0 +1,30 @@
+#ifndef TA_OBJECT_POOL_H
+#define TA_OBJECT_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Arena with per-size free lists for game objects, all memory is released when the pool is destroyed
+class TA_ObjectPool {
+private:
+    static constexpr size_t blockSize = 64 * 1024;
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks, largeBlocks; // objects are carved from the last block
+    std::unordered_map<size_t, std::vector<void*>> freeLists;
+    size_t blockOffset = blockSize;
+
+    static size_t getSizeClass(size_t size) {return (size + alignment - 1) / alignment * alignment;}
+
+public:
+    TA_ObjectPool() = default;
+    TA_ObjectPool(const TA_ObjectPool&) = delete;
+    TA_ObjectPool& operator=(const TA_ObjectPool&) = delete;
+
+    void* allocate(size_t size);
+    void release(void *memory, size_t size);
+};
+
+#endif // TA_OBJECT_POOL_H
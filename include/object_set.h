@@ -1,25 +1,73 @@
 #ifndef TA_OBJECT_SET_H
 #define TA_OBJECT_SET_H
 
+#include <memory>
+#include <new>
+#include <unordered_map>
 #include <vector>
 #include "geometry.h"
 #include "pawn.h"
 #include "tilemap.h"
 #include "hitbox_container.h"
+#include "object_pool.h"
 #include "screen.h"
 #include "links.h"
 #include "tools.h"
 #include "character.h"
+#include "level_file.h"
+#include "state_buffer.h"
 
 class TA_ObjectSet;
 enum TA_BombMode : int;
 
-class TA_Object : public TA_Pawn {
-private:
-    bool checkPawnCollision(TA_Polygon &rv) override {return false;}
+enum TA_ObjectType {
+    TA_OBJECT_BREAKABLE_BLOCK,
+    TA_OBJECT_WALKER,
+    TA_OBJECT_HOVER_POD,
+    TA_OBJECT_PUSHABLE_ROCK,
+    TA_OBJECT_PUSHABLE_SPRING,
+    TA_OBJECT_SPAWN_POINT,
+    TA_OBJECT_LEVEL_TRANSITION,
+    TA_OBJECT_MAP_TRANSITION,
+    TA_OBJECT_BRIDGE,
+    TA_OBJECT_CAMERA_LOCK_POINT,
+    TA_OBJECT_BIRD_WALKER,
+    TA_OBJECT_BAT_ROBOT,
+    TA_OBJECT_SOUND,
+    TA_OBJECT_NEZU,
+    TA_OBJECT_FLAME,
+    TA_OBJECT_FIRE,
+    TA_OBJECT_ITEM_BOX,
+    TA_OBJECT_DRILL_MOLE,
+    TA_OBJECT_MOVING_PLATFORM,
+    TA_OBJECT_BOMB_THROWER,
+    TA_OBJECT_ROCK_THROWER,
+    TA_OBJECT_JUMPER,
+    TA_OBJECT_WIND,
+    TA_OBJECT_STRONG_WIND,
+    TA_OBJECT_SPEEDY,
+    TA_OBJECT_MECHA_GOLEM,
+    TA_OBJECT_GRASS_BLOCK,
+    TA_OBJECT_MINI_SUB,
+    TA_OBJECT_MINE,
+    TA_OBJECT_CONVEYOR_BELT,
+    TA_OBJECT_RING
+};
 
+// one <object> of a level's .xml, decoded once so baked level files can store it directly
+struct TA_ObjectSpawn {
+    int type = TA_OBJECT_BREAKABLE_BLOCK;
+    TA_Point position, end, velocity; // position is the top left corner for areas and the start for moving platforms
+    double value = 0, secondValue = 0;
+    bool flag = false;
+    std::string path, secondPath;
+};
+
+class TA_Object : public TA_Pawn {
 protected:
     virtual void updatePosition();
+    bool checkPawnCollision(TA_Polygon &hitbox) override;
+    void addCollisionCandidates(TA_Rect bounds, std::vector<TA_CollisionHitbox> &candidates) override;
 
 public:
     TA_ObjectSet *objectSet;
@@ -30,19 +78,36 @@ public:
         int collisionType;
     };
     std::vector<HitboxVectorElement> hitboxVector;
+    std::vector<int> staticHitboxIds; // managed by TA_ObjectSet
+    size_t allocationSize = 0; // managed by TA_ObjectSet
+    uint32_t id = 0; // managed by TA_ObjectSet, identifies the object in snapshots
 
     TA_Object(TA_ObjectSet *newObjectSet);
     virtual bool update() {return false;}
     virtual bool checkCollision(TA_Polygon rv) {return getCollisionType() != TA_COLLISION_TRANSPARENT && hitbox.intersects(rv);}
     virtual int getCollisionType() {return TA_COLLISION_TRANSPARENT;}
     virtual int getDrawPriority() {return 0;}
+    // static objects never move their hitboxes, so they are kept in the static layer of the hitbox container
+    virtual bool isStatic() {return false;}
     TA_Point getDistanceToCharacter();
     virtual void destroy() {}
+    // fields that change after load, the base classes first
+    void serialize(TA_StateBuffer &buffer) override;
     virtual ~TA_Object() = default;
 };
 
 class TA_ObjectSet {
 private:
+    // tilemap and object hitboxes near the character, gathered once per frame
+    struct CollisionContext {
+        std::vector<TA_CollisionHitbox> candidates;
+        TA_Rect bounds;
+        bool active = false;
+    };
+
+    static inline long long avoidedQueries = 0;
+
+    TA_ObjectPool objectPool; // must outlive the objects and the snapshots holding their prototypes
     std::vector<TA_Object*> objects, spawnedObjects, deleteList;
     TA_Links links;
     TA_HitboxContainer hitboxContainer;
@@ -50,6 +115,28 @@ private:
     TA_ScreenState transition = TA_SCREENSTATE_CURRENT;
     bool spawnFlip = false, firstSpawnPointSet = false;
     bool paused = false;
+    CollisionContext collisionContext;
+    uint32_t nextObjectId = 0;
+    std::unordered_map<uint32_t, std::shared_ptr<TA_Object>> prototypes; // by id, for objects in snapshots
+
+    void updateStaticHitboxes(TA_Object *object);
+    void removeStaticHitboxes(TA_Object *object);
+    bool isInCollisionContext(TA_Point topLeft, TA_Point bottomRight);
+    void deleteObject(TA_Object *object);
+    void load(int chunkSize, const std::vector<TA_ObjectSpawn> &spawns);
+    void loadObject(const TA_ObjectSpawn &spawn);
+    void saveObjects(TA_Snapshot &snapshot);
+    void loadObjects(TA_Snapshot &snapshot);
+    static TA_Object* cloneObject(const TA_Object &object, void *memory);
+
+    template<class T>
+    T* createObject() {
+        T* object = new(objectPool.allocate(sizeof(T))) T(this);
+        object->allocationSize = sizeof(T);
+        object->id = ++ nextObjectId;
+        return object;
+    }
+    int getWorldCollisionFlags(TA_Polygon &hitbox, int mask);
 
 public:
     ~TA_ObjectSet();
@@ -60,12 +147,28 @@ public:
     void setLinks(TA_Links newLinks) {links = newLinks;}
     TA_Links getLinks() {return links;}
 
+    // queue the tilemap and object textures of a level for background loading
+    static void prefetchLevel(std::string levelPath);
     void load(std::string filename);
+    void load(TA_LevelFile &file);
+    static void parseObjects(std::string filename, int &chunkSize, std::vector<TA_ObjectSpawn> &spawns);
+    static void writeObjects(TA_LevelFileWriter &writer, int chunkSize, const std::vector<TA_ObjectSpawn> &spawns);
+    // leaves file failed if it is truncated
+    static void readObjects(TA_LevelFile &file, int &chunkSize, std::vector<TA_ObjectSpawn> &spawns);
     void update();
     void draw(int priority);
+    // objects and the set's own state, objects deleted since saving are cloned from the snapshot's prototypes
+    void serialize(TA_Snapshot &snapshot);
 
     void checkCollision(TA_Polygon &hitbox, int &flags);
     int checkCollision(TA_Polygon &hitbox);
+    // same as checkCollision(hitbox) & mask, but skips sources which can't contribute to mask
+    int checkCollisionTypes(TA_Polygon &hitbox, int mask);
+    void addCollisionCandidates(TA_Rect bounds, int mask, std::vector<TA_CollisionHitbox> &candidates);
+    // queries inside bounds are answered from a local list until the context ends, with identical results
+    void beginCollisionContext(TA_Rect bounds);
+    void endCollisionContext() {collisionContext.active = false;}
+    static long long getAvoidedQueries() {return avoidedQueries;}
     void setTransition(TA_ScreenState screenState) {transition = screenState;}
     TA_ScreenState getTransition() {return transition;}
     bool hasCollisionType(TA_CollisionType type) {return hitboxContainer.hasCollisionType(type);}
@@ -82,7 +185,7 @@ public:
 
     template<class T, typename... P>
     void spawnObject(P... params) {
-        auto* object = new T(this);
+        auto* object = createObject<T>();
         object->load(params...);
         spawnedObjects.push_back(object);
     }
@@ -20,13 +20,15 @@ private:
     TA_Point velocity;
     State state = STATE_IDLE;
     double timer = 0;
+    int idleAnimation, activeAnimation, attackAnimation;
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point newPosition);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE | TA_COLLISION_TARGET;}
-    bool checkPawnCollision(TA_Polygon &collisionHitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID;}
 };
 
 #endif // TA_BAT_ROBOT_H
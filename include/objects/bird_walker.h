@@ -55,9 +55,13 @@ private:
     TA_Polygon weakHitbox;
 
     double floorY, timer = 0, jumpTimer = 0, flashTimer = damageFlashTime * 5;
+    int headIdleAnimation, headLaughAnimation, headTurnAnimation;
+    int headIdleFlipAnimation, headLaughFlipAnimation;
+    int feetIdleAnimation, feetWalkAnimation;
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(double newFloorY);
     bool update() override;
     void draw() override;
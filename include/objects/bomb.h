@@ -39,10 +39,11 @@ protected:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     virtual void load(TA_Point newPosition, bool newDirection, TA_BombMode mode);
     bool update() override;
 
-    bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP | TA_COLLISION_PUSHABLE;}
     int getCollisionType() override {return TA_COLLISION_BOMB;}
     int getDrawPriority() override {return 1;}
 };
@@ -72,6 +73,7 @@ private:
 class TA_TripleBomb : public TA_Bomb {
 public:
     using TA_Bomb::TA_Bomb;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point newPosition, bool newDirection, TA_BombMode mode) override;
     bool update() override;
     void draw() override;
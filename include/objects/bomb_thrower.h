@@ -29,9 +29,11 @@ private:
     double leftX, rightX;
     bool direction = false;
     double timer = 0;
+    int idleAnimation, walkAnimation;
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, double leftX, double rightX);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE | TA_COLLISION_TARGET;}
@@ -46,10 +48,11 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE;}
-    bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP | TA_COLLISION_CHARACTER;}
 };
 
 #endif // TA_BOMB_THROWER_H
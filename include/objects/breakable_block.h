@@ -12,9 +12,11 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(std::string path, std::string newParticlePath, TA_Point newPosition, bool newDropsRing);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_SOLID;}
+    bool isStatic() override {return true;}
     int getDrawPriority() override {return 0;}
 };
 
@@ -25,9 +25,11 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point newPosition, std::string filename, std::string newParticleFilename);
     bool update() override;
     int getCollisionType() override;
+    bool isStatic() override {return true;}
 };
 
 #endif // TA_BRIDGE_H
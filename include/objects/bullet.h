@@ -13,6 +13,7 @@ protected:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(std::string filename, TA_Point newPosition, TA_Point newVelocity, int frameWidth = -1, int frameHeight = -1);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE;}
@@ -37,6 +38,7 @@ private:
 
 public:
     using TA_Bullet::TA_Bullet;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, TA_Point velocity);
     bool update() override;
     void onDestroy() override;
@@ -9,9 +9,11 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point topLeft, TA_Point bottomRight, bool direction);
     bool update() {return true;}
     int getCollisionType() {return collisionType;}
+    bool isStatic() override {return true;}
 };
 
 #endif // TA_CONVEYOR_BELT_H
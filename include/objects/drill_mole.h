@@ -26,6 +26,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE | TA_COLLISION_TARGET;}
@@ -18,6 +18,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, int newDelay = 0, TA_ExplosionType type = TA_EXPLOSION_CHARACTER);
     bool update() override;
     void draw() override;
@@ -12,6 +12,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, double startSpeed);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE;}
@@ -26,6 +27,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, double startSpeed = 3.75);
     bool update() override;
 };
@@ -12,6 +12,7 @@ public:
     void load(TA_Point position, std::string texture);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_SOLID;}
+    bool isStatic() override {return true;}
 };
 
 #endif // TA_GRASS_BLOCK_H
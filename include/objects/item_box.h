@@ -43,10 +43,11 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, TA_Point velocity, int itemNumber, std::string itemName);
     bool update() override;
     int getDrawPriority() override;
-    bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP;}
 };
 
 class TA_ItemLabel : public TA_Object {
@@ -62,6 +63,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, std::string name);
     bool update() override;
     void draw() override;
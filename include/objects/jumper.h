@@ -23,7 +23,7 @@ private:
     void setJumpVelocity();
     void updateDirection();
     bool isCloseToCharacter();
-    bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP;}
     bool shouldBeDestroyed();
     void destroy() override;
 
@@ -31,9 +31,11 @@ private:
     TA_Point velocity;
     bool direction = false;
     double timer = 0;
+    int jumpAnimation;
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE | TA_COLLISION_TARGET;}
@@ -6,6 +6,7 @@
 class TA_MechaGolem : public TA_Object {
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load();
     bool update() override;
     void draw() override;
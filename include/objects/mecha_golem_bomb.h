@@ -6,6 +6,7 @@
 class TA_MechaGolemBomb : public TA_Object {
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE;}
@@ -20,6 +20,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point startPosition, TA_Point endPosition, bool idle = true);
     bool update() override;
     int getCollisionType() override;
@@ -7,10 +7,11 @@ class TA_NapalmFire : public TA_Object {
 private:
     TA_Point velocity, topLeft{0, 23}, bottomRight{8, 31};
 
-    bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP | TA_COLLISION_PUSHABLE;}
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, double xsp);
     bool update() override;
 };
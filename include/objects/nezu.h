@@ -33,9 +33,11 @@ private:
     State state = STATE_IDLE;
     bool direction = 0, bombPlaced = 0;
     double timer = 0, fallSpeed = 0;
+    int idleAnimation, walkAnimation;
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE | TA_COLLISION_TARGET;}
@@ -49,6 +51,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position);
     bool update();
 };
@@ -10,6 +10,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(std::string filename, TA_Point newPosition, TA_Point newVelocity, TA_Point newDelta, double newDelay = 0);
     bool update() override;
 };
@@ -12,10 +12,11 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(std::string filename, TA_Point newPosition);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_PUSHABLE;}
-    bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP;}
 };
 
 class TA_PushableRock : public TA_PushableObject {
@@ -32,6 +33,7 @@ private:
 
 public:
     using TA_PushableObject::TA_PushableObject;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point newPosition);
     bool update() override;
     void draw() override;
@@ -21,11 +21,12 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, TA_Point velocity, double delay = 0);
     void load(TA_Point position, double startSpeed = -2);
     void loadStationary(TA_Point position);
     bool update() override;
-    bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP;}
     int getDrawPriority() override {return 1;}
 };
 
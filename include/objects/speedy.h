@@ -65,6 +65,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load();
     bool update() override;
     void draw() override;
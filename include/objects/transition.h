@@ -13,6 +13,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point topLeft, TA_Point bottomRight, std::string levelPath);
     void load(TA_Point topLeft, TA_Point bottomRight, int selection, bool seaFox);
     bool update() override;
@@ -29,9 +29,11 @@ private:
     double timer = 0;
     bool alwaysIdle = false;
     TA_WalkerState state = TA_WALKER_STATE_IDLE;
+    int idleAnimation, walkAnimation, fireAnimation;
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point newPosition, int range, bool flip);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE | TA_COLLISION_TARGET;}
@@ -45,6 +47,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point newPosition, bool newDirection);
     bool update() override;
     int getCollisionType() override {return TA_COLLISION_DAMAGE;}
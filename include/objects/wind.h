@@ -26,6 +26,7 @@ protected:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point topLeft, TA_Point bottomRight, TA_Point velocity);
     bool update();
 };
@@ -39,6 +40,7 @@ protected:
 
 public:
     using TA_Wind::TA_Wind;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point topLeft, TA_Point bottomRight);
 };
 
@@ -51,6 +53,7 @@ private:
 
 public:
     using TA_Object::TA_Object;
+    void serialize(TA_StateBuffer &buffer) override;
     void load(TA_Point position, TA_Point velocity);
     bool update();
 };
@@ -1,8 +1,10 @@
 #ifndef TA_PAWN_H
 #define TA_PAWN_H
 
+#include <vector>
 #include "sprite.h"
 #include "geometry.h"
+#include "tilemap.h"
 
 enum TA_COLLISION_STATE {
     TA_GROUND_COLLISION = (1 << 0),
@@ -11,24 +13,63 @@ enum TA_COLLISION_STATE {
     TA_COLLISION_ERROR = (1 << 3)
 };
 
+enum TA_PawnCollisionSolver {
+    TA_PAWN_SOLVER_BISECTION,
+    TA_PAWN_SOLVER_SWEEP,
+    TA_PAWN_SOLVER_SWEEP_CHECKED // sweep, compared against bisection on every move
+};
+
 class TA_Pawn : public TA_Sprite {
 private:
+    static constexpr double sweepMargin = 0.01, moveEpsilon = 1e-5, popOutDistance = 32;
+
+    static inline TA_PawnCollisionSolver collisionSolver = TA_PAWN_SOLVER_BISECTION;
+
     TA_Point topLeft, bottomRight, velocity;
     bool ground;
+    struct SweepInterval {
+        double enter, exit;
+        bool touching; // the ends block too, only rectangles don't intersect when touching
+    };
+
+    std::vector<TA_CollisionHitbox> sweepCandidates; // kept to reuse the capacity
+    std::vector<SweepInterval> sweepIntervals;
 
     void moveByX();
     void moveByY();
+    double getMoveFactor(TA_Polygon &hitbox, TA_Point delta);
+    double getBisectionMoveFactor(TA_Polygon &hitbox, TA_Point delta);
+    double getSweepMoveFactor(TA_Polygon &hitbox, TA_Point delta);
     void popOut();
+    TA_Point getPopOutShift(bool sweep);
     double getFirstGood(TA_Point delta);
+    double getSweepFirstGood(TA_Point delta);
     bool isGoodPosition(TA_Point position);
 
+    void computeSweepIntervals(TA_Polygon &hitbox, TA_Point delta);
+    bool isSweepBlocked(double factor);
+
+    template<typename Predicate>
+    static double bisectMoveFactor(Predicate isOutside, double distance);
+    template<typename Predicate>
+    static double bisectFirstGood(Predicate isGood, double distance);
+
 protected:
     TA_Point position;
     int getCollisionFlags(TA_Point topLeft, TA_Point bottomRight);
 
+    // collision types which block this pawn, used by the sweep solver; 0 means only checkPawnCollision is known
+    virtual int getSolidCollisionMask() {return 0;}
+    virtual void addCollisionCandidates(TA_Rect, std::vector<TA_CollisionHitbox>&) {}
+
 public:
-    virtual bool checkPawnCollision(TA_Polygon &hitbox) {return false;}
+    static void setCollisionSolver(TA_PawnCollisionSolver solver) {collisionSolver = solver;}
+    // moves pawns through random tile scenes with both solvers, false if any landing position or flag differs
+    static bool checkSolversOnScenes();
+
+    virtual bool checkPawnCollision(TA_Polygon&) {return false;}
     int moveAndCollide(TA_Point topLeft, TA_Point bottomRight, TA_Point velocity, bool ground = false);
+    void serialize(TA_StateBuffer &buffer) override;
 };
 
 #endif // TA_PAWN_H
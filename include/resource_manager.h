@@ -1,16 +1,41 @@
 #ifndef TA_RESOURCE_MANAGER_H
 #define TA_RESOURCE_MANAGER_H
 
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include "SDL3/SDL.h"
 #include "SDL3_mixer/SDL_mixer.h"
 
+struct TA_ResourceUsage {
+    size_t textureBytes = 0, musicBytes = 0, chunkBytes = 0, assetBytes = 0;
+
+    size_t total() const {return textureBytes + musicBytes + chunkBytes + assetBytes;}
+};
+
 namespace TA { namespace resmgr {
     void preload();
-    SDL_Texture* loadTexture(std::string filename);
-    Mix_Music* loadMusic(std::string filename);
-    Mix_Chunk* loadChunk(std::string filename);
-    std::string loadAsset(std::string filename);
+    // resources are cached while a handle exists, the preloaded ones are never evicted
+    std::shared_ptr<SDL_Texture> loadTexture(std::string filename);
+    std::shared_ptr<Mix_Music> loadMusic(std::string filename);
+    std::shared_ptr<Mix_Chunk> loadChunk(std::string filename);
+    // valid until the next collect
+    std::string_view loadAsset(std::string filename);
+
+    // background loading, safe to call from any thread: files are decoded on loader threads,
+    // load functions above take the result or wait for it, textures are created on the main thread
+    void prefetchTexture(std::string filename);
+    void prefetchChunk(std::string filename);
+    // onLoaded runs on the loader thread, e.g. to prefetch what the asset references
+    void prefetchAsset(std::string filename, std::function<void(std::string_view)> onLoaded = {});
+    void runInBackground(std::function<void()> task);
+    // creates textures for finished prefetches, called once per frame
+    void update();
+    // called between screens, frees unused resources not needed for cache_screens screens
+    // (least recently used first) until the cache fits into cache_budget MiB
+    void collect();
+    TA_ResourceUsage getMemoryUsage();
     void quit();
 }}
 
@@ -0,0 +1,57 @@
+#ifndef TA_REWIND_BUFFER_H
+#define TA_REWIND_BUFFER_H
+
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "state_buffer.h"
+
+// Snapshots of the last steps, newest last. Every keyframeInterval steps, or when objects were spawned
+// or deleted, a snapshot is kept whole, the ones after it are XORed with it and stored as runs of changed bytes.
+class TA_RewindBuffer {
+private:
+    using Prototypes = std::vector<std::shared_ptr<TA_Object>>;
+
+    struct Group {
+        std::vector<unsigned char> keyframe;
+        std::vector<std::vector<unsigned char>> deltas;
+        std::vector<std::shared_ptr<const Prototypes>> prototypes; // of the keyframe and every delta
+        size_t bytes = 0; // approximately, prototypes aren't included
+    };
+
+    static constexpr size_t keyframeInterval = 30;
+
+    static inline size_t memoryUsage = 0;
+    static inline long long captureTime = 0;
+
+    std::deque<Group> groups;
+    std::shared_ptr<const Prototypes> lastPrototypes; // consecutive steps usually share them
+    std::unordered_map<const TA_Object*, int> prototypeUses; // lists holding each prototype, its memory is counted once
+    size_t capacity = 0, size = 0;
+
+    std::shared_ptr<const Prototypes> makePrototypes(const Prototypes &prototypes);
+    void releasePrototypes(const Prototypes *prototypes);
+
+    static void encode(const std::vector<unsigned char> &data, const std::vector<unsigned char> &keyframe, std::vector<unsigned char> &delta);
+    static void decode(const std::vector<unsigned char> &delta, const std::vector<unsigned char> &keyframe, std::vector<unsigned char> &data);
+
+public:
+    TA_RewindBuffer() = default;
+    TA_RewindBuffer(const TA_RewindBuffer&) = delete;
+    TA_RewindBuffer& operator=(const TA_RewindBuffer&) = delete;
+    ~TA_RewindBuffer() {clear();}
+    void setCapacity(size_t steps) {capacity = steps;}
+    bool isEnabled() const {return capacity != 0;}
+    void push(TA_Snapshot &snapshot);
+    // takes the newest snapshot, false if there is none
+    bool pop(TA_Snapshot &snapshot);
+    void clear();
+
+    // for the frame time overlay: bytes held by the rewind buffer and microseconds spent capturing so far
+    static size_t getMemoryUsage() {return memoryUsage;}
+    static long long getCaptureTime() {return captureTime;}
+    static void addCaptureTime(long long microseconds) {captureTime += microseconds;}
+};
+
+#endif // TA_REWIND_BUFFER_H
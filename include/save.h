@@ -1,19 +1,43 @@
 #ifndef TA_SAVE_H
 #define TA_SAVE_H
 
+#include <functional>
 #include <string>
 
+class TA_StateBuffer;
+
+// Interned parameter names for code that reads them often, lookups through handles are array reads
+
+struct TA_ParameterHandle {
+    int id = -1;
+};
+
+// resolves to the parameter in the current save
+struct TA_SaveParameterHandle {
+    int id = -1;
+};
+
 namespace TA { namespace save {
     void load();
     void writeToFile();
+    TA_ParameterHandle getParameterHandle(std::string name);
+    TA_SaveParameterHandle getSaveParameterHandle(std::string name);
     long long getParameter(std::string name);
+    long long getParameter(TA_ParameterHandle handle);
     void setParameter(std::string name, long long value);
+    void setParameter(TA_ParameterHandle handle, long long value);
+    // listener is called whenever setParameter changes the value, for subsystems living until exit
+    void addListener(TA_ParameterHandle handle, std::function<void()> listener);
     void setCurrentSave(std::string name);
     long long getSaveParameter(std::string name, std::string saveName = "");
+    long long getSaveParameter(TA_SaveParameterHandle handle);
     void setSaveParameter(std::string name, long long value, std::string saveName = "");
+    void setSaveParameter(TA_SaveParameterHandle handle, long long value);
     void createSave(std::string saveName);
     void repairSave(std::string saveName);
     bool saveExists(int save);
+    // parameters of the current save, for game state snapshots
+    void serializeCurrentSave(TA_StateBuffer &buffer);
 }}
 
 #endif // TA_SAVE_H
@@ -21,6 +21,10 @@ class TA_Screen {
 public:
     virtual void init() {}
     virtual TA_ScreenState update() {return TA_SCREENSTATE_CURRENT;}
+    // fixed step screens simulate in update() at 60 Hz and render in draw() once per frame,
+    // others do both in update() once per frame with a variable TA::elapsedTime
+    virtual bool isFixedStep() {return false;}
+    virtual void draw() {}
     virtual void quit() {} // TODO: is this really needed?
     virtual ~TA_Screen() = default;
 };
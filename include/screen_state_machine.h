@@ -9,6 +9,7 @@ private:
     TA_ScreenState currentState, neededState;
     std::unique_ptr<TA_Screen> currentScreen;
     double transitionTimer = 0;
+    int shadowAlpha = 0;
     bool changeState = false, quitNeeded = false;
 
     const double transitionTime = 6;
@@ -16,6 +17,8 @@ private:
 public:
     void init();
     bool update();
+    void draw();
+    bool isFixedStep() {return currentScreen->isFixedStep();}
     bool isQuitNeeded() {return quitNeeded;}
     ~TA_ScreenStateMachine();
 };
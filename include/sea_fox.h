@@ -30,6 +30,8 @@ private:
     void dropRings();
     void updateDead();
     bool checkPawnCollision(TA_Polygon &hitbox) override;
+    int getSolidCollisionMask() override {return TA_COLLISION_SOLID;}
+    void addCollisionCandidates(TA_Rect bounds, std::vector<TA_CollisionHitbox> &candidates) override;
 
     TA_Links links;
     TA_Point velocity{0, 0};
@@ -51,6 +53,7 @@ public:
     TA_Polygon* getHitbox() {return &hitbox;}
     TA_Polygon* getDrillHitbox() {return &drillHitbox;}
     bool gameOver() {return dead && deadTimer >= deadTime;}
+    void serialize(TA_StateBuffer &buffer) override;
 };
 
 #endif // TA_SEA_FOX_H
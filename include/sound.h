@@ -1,6 +1,7 @@
 #ifndef TA_SOUND_H
 #define TA_SOUND_H
 
+#include <memory>
 #include <string>
 #include "SDL3_mixer/SDL_mixer.h"
 
@@ -14,7 +15,7 @@ enum TA_SoundChannel
 
 namespace TA::sound {
     void playMusic(std::string filename, int repeat = -1);
-    void update();
+    void init();
     bool isPlaying(TA_SoundChannel channel);
     bool isMusicPlaying();
     void fadeOut(int time);
@@ -25,7 +26,7 @@ namespace TA::sound {
 class TA_Sound
 {
 private:
-    Mix_Chunk *chunk = nullptr;
+    std::shared_ptr<Mix_Chunk> chunk;
     TA_SoundChannel channel = TA_SOUND_CHANNEL_SFX1;
     bool loop = false;
 
@@ -33,7 +34,7 @@ public:
     void load(std::string filename, TA_SoundChannel channel, bool loop = false);
     void play();
     void fadeOut(int time);
-    void clear() {chunk = nullptr;}
+    void clear() {chunk.reset();}
     bool empty() {return chunk == nullptr;}
 };
 
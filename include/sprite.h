@@ -3,16 +3,19 @@
 
 #include <vector>
 #include <string>
-#include <map>
+#include <memory>
+#include <unordered_map>
 #include "SDL3/SDL.h"
 #include "SDL3_image/SDL_image.h"
 #include "geometry.h"
 #include "camera.h"
+#include "state_buffer.h"
 
 class TA_Texture {
 public:
     virtual void load(std::string filename);
 
+    std::shared_ptr<SDL_Texture> handle; // keeps SDLTexture in the resource cache
     SDL_Texture *SDLTexture = nullptr;
     int width = 0, height = 0;
 };
@@ -29,22 +32,43 @@ public:
     TA_Animation(int frame);
 };
 
+// Animations from one file, parsed once and shared by all sprites
+class TA_AnimationSet {
+private:
+    std::vector<TA_Animation> animations;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> ids;
+
+    void parse(std::string filename);
+
+public:
+    static const TA_AnimationSet* load(std::string filename);
+    int getId(const std::string &name) const;
+    const TA_Animation& getAnimation(int id) const {return animations[id];}
+    const std::string& getName(int id) const {return names[id];}
+};
+
 class TA_Sprite {
 private:
     TA_Texture texture;
     int frameWidth = 0, frameHeight = 0;
     int frame = 0;
-    TA_Point position;
+    TA_Point position, previousPosition; // previousPosition is the position before positionTick
+    long long positionTick = -1;
     TA_Camera *camera = nullptr;
 
-    std::map<std::string, TA_Animation> loadedAnimations;
-    TA_Animation animation;
+    const TA_AnimationSet *animationSet = nullptr;
+    std::shared_ptr<const TA_Animation> customAnimation;
+    const TA_Animation *animation = nullptr; // nullptr means staticFrame is shown
+    int staticFrame = 0, animationId = -1, repeatTimesLeft = -1;
     int animationFrame = 0;
     double animationTimer = 0;
     bool flip = false, hidden = false, updateAnimationNeeded = true, loaded = false;
     bool doUpdateAnimation = true;
     int alpha = 255;
-    std::string animationName;
+
+    bool isCurrentAnimation(const TA_Animation &other);
+    void startAnimation(const TA_Animation *newAnimation);
 
 public:
     void load(std::string filename, int frameWidth = -1, int frameHeight = -1);
@@ -52,7 +76,7 @@ public:
     virtual void draw();
     void drawFrom(SDL_Rect srcRect);
 
-    void setPosition(TA_Point newPosition) {position = newPosition;}
+    void setPosition(TA_Point newPosition);
     void setPosition(double newX, double newY) {setPosition(TA_Point(newX, newY));}
     void setAlpha(int newAlpha);
     void setCamera(TA_Camera *newCamera) {camera = newCamera;}
@@ -63,17 +87,25 @@ public:
     int getHeight() {return frameHeight;}
     bool getFlip() {return flip;}
     TA_Point getPosition() {return position;}
+    // position between the last two simulation steps, see TA::interpolation
+    TA_Point getDrawPosition();
 
     void loadAnimationsFromFile(std::string filename);
+    int getAnimationId(const std::string &name);
     void setAnimation(std::string name);
+    void setAnimationById(int id);
     void setAnimation(TA_Animation newAnimation);
     void setFrame(int newFrame);
     bool isAnimated();
     int getAnimationFrame();
     int getCurrentFrame();
-    std::string getAnimationName() {return (isAnimated() ? animationName : "");}
+    std::string getAnimationName() {return (isAnimated() && animationId != -1 ? animationSet->getName(animationId) : "");}
+    bool isPlayingAnimation(int id) {return isAnimated() && id != -1 && animationId == id;}
     void updateAnimation();
     void setUpdateAnimation(bool enabled) {doUpdateAnimation = enabled;}
+
+    // state that changes after load, the texture and animation set stay
+    virtual void serialize(TA_StateBuffer &buffer);
 };
 
 #endif //TA_SPRITE_H
@@ -0,0 +1,73 @@
+#ifndef TA_STATE_BUFFER_H
+#define TA_STATE_BUFFER_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "error.h"
+
+class TA_Object;
+
+// Binary game state. serialize functions pass their fields to sync(), which writes them
+// or reads them back depending on the mode, so both directions share one field list.
+class TA_StateBuffer {
+private:
+    std::vector<unsigned char> data;
+    size_t readPosition = 0;
+    bool reading = false;
+
+    void syncBytes(void *bytes, size_t size) {
+        if(reading) {
+            if(size > data.size() - readPosition) {
+                TA::handleError("%s", "Game state is truncated");
+            }
+            std::memcpy(bytes, data.data() + readPosition, size);
+            readPosition += size;
+        }
+        else {
+            const unsigned char *begin = static_cast<const unsigned char*>(bytes);
+            data.insert(data.end(), begin, begin + size);
+        }
+    }
+
+public:
+    // keeps the capacity, so writing a state of the same size doesn't allocate
+    void startWriting() {data.clear(); reading = false;}
+    void startReading() {readPosition = 0; reading = true;}
+    [[nodiscard]] bool isReading() const {return reading;}
+    std::vector<unsigned char> &getData() {return data;}
+
+    template<typename T>
+    void sync(T &value) {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values are stored as bytes");
+        syncBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    void sync(std::vector<T> &values) {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values are stored as bytes");
+        uint32_t size = values.size();
+        sync(size);
+        if(reading) {
+            values.resize(size);
+        }
+        syncBytes(values.data(), size * sizeof(T));
+    }
+
+    template<typename T, typename... Rest>
+    void sync(T &value, Rest&... rest) {
+        sync(value);
+        sync(rest...);
+    }
+};
+
+// A saved game state, see TA_GameScreen::saveState. Objects deleted after saving
+// are recreated from prototypes, copies which own their textures and sounds.
+struct TA_Snapshot {
+    TA_StateBuffer buffer;
+    std::vector<std::shared_ptr<TA_Object>> prototypes;
+};
+
+#endif // TA_STATE_BUFFER_H
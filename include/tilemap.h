@@ -4,9 +4,12 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <cstdint>
+#include <utility>
 #include "sprite.h"
 #include "camera.h"
 #include "geometry.h"
+#include "level_file.h"
 
 enum TA_CollisionType {
     TA_COLLISION_TRANSPARENT = 0,
@@ -28,6 +31,11 @@ enum TA_CollisionType {
     TA_COLLISION_TARGET = (1 << 15)
 };
 
+struct TA_CollisionHitbox {
+    TA_Polygon polygon;
+    int type;
+};
+
 class TA_Tilemap {
 private:
     struct Hitbox {
@@ -38,31 +46,98 @@ private:
     struct Tile {
         TA_Sprite sprite;
         std::vector<Hitbox> hitboxes;
-        int type = 0;
+        std::vector<int> animationFrames;
+        int type = 0, animationClock = -1;
+    };
+
+    // shared by all tile animations with the same timing, works like TA_Sprite::updateAnimation
+    struct AnimationClock {
+        int delay, length, frame = 0;
+        double timer = 0;
     };
 
+    struct Chunk {
+        // static tiles rendered at scale 1, nullptr until the chunk is first visible
+        SDL_Texture *texture = nullptr;
+        // tiles with animation, drawn over the texture every frame
+        std::vector<std::pair<int, int>> animatedTiles;
+        int lastDrawFrame = 0;
+    };
+
+    // chunk textures not drawn for this many frames are freed, they are rendered again when visible
+    static constexpr int chunkLifetime = 120;
+
     std::vector<Hitbox> getSpikesHitboxVector(int type);
     Hitbox getSpikesSolidHitbox(int type);
     Hitbox getSpikesDamageHitbox(int type);
+    int getTile(int layer, int tileX, int tileY) const {return tilemap[layer][tileY * width + tileX];}
+    void initStorage(int tileCount);
+    void loadTilesetTexture(std::string filename);
+    void finishLoading();
+    void addTileAnimation(int tileId, const TA_Animation &animation);
+    void updateAnimations();
+    void updateTileFrames();
+    void drawLayer(int layer);
+    void drawChunks(int layer, int lx, int rx, int ly, int ry);
+    void renderChunk(int layer, int chunkX, int chunkY);
+    void destroyChunks();
+    void releaseChunkTextures(bool all);
+    void addTileVertices(int tileId, TA_Point tilePosition, int cameraX, int cameraY, int scale);
+    void flushTileVertices();
+    void drawTilesBySprites(int layer, int lx, int rx, int ly, int ry);
+    void checkTileBatching(int layer, int lx, int rx, int ly, int ry);
 
-    std::vector<std::vector<std::vector<int>>> tilemap;
+    // tile ids of each layer row by row (index tileY * width + tileX), -1 is empty
+    std::vector<std::vector<int16_t>> tilemap;
+    // nonEmptyRows[layer][tileY] is set if the row has any tile
+    std::vector<std::vector<uint8_t>> nonEmptyRows;
     std::vector<Tile> tileset;
+    std::vector<AnimationClock> animationClocks;
+    std::vector<int> animatedTiles;
+    // current frame of every tile, only animated tiles change it
+    std::vector<int> tileFrames;
+    TA_Texture tilesetTexture;
+    std::string tilesetFilename;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    std::vector<std::vector<Chunk>> chunks;
+    std::vector<std::pair<int, int>> renderedChunks; // layer and index of every chunk with a texture
+    int chunkWidth = 1, chunkHeight = 1, chunkCountX = 0, chunkCountY = 0;
+    int drawFrame = 0, renderResetCount = 0;
     std::array<TA_Polygon, 3> borderPolygons;
     std::vector<int> collisionLayers;
     TA_Camera* camera = nullptr;
     TA_Point position;
     int width, height, tileWidth, tileHeight, layerCount;
+    int collisionTypeMask = TA_COLLISION_SOLID;
     bool updateAnimation = true;
+    bool checkBatching = false; // --check-tile-batching
 
 public:
+    TA_Tilemap() = default;
+    TA_Tilemap(const TA_Tilemap &other) = delete;
+    TA_Tilemap &operator=(const TA_Tilemap &other) = delete;
+    ~TA_Tilemap();
+
+    // queue the map and its tileset texture for background loading
+    static void prefetch(std::string filename);
+    // same for a baked level, file must be at the start of the tilemap section and is left after its end
+    static void prefetch(TA_LevelFile &file);
     void load(std::string filename);
+    void load(TA_LevelFile &file);
+    void bake(TA_LevelFileWriter &writer) const;
     void draw(int priority);
     void setCamera(TA_Camera *newCamera);
     void setPosition(TA_Point position);
     int getWidth() {return width * tileWidth;}
     int getHeight() {return height * tileHeight;}
-    int checkCollision(TA_Polygon &polygon);
+    int checkCollision(const TA_Polygon &polygon) const {return checkCollision(polygon, -1);}
+    // only types from mask are reported, returns as soon as all of them are found
+    int checkCollision(const TA_Polygon &polygon, int mask) const;
+    int getCollisionTypeMask() const {return collisionTypeMask;}
+    void addCollisionCandidates(TA_Rect bounds, int mask, std::vector<TA_CollisionHitbox> &candidates);
     void setUpdateAnimation(bool enabled);
+    void serialize(TA_StateBuffer &buffer);
 };
 
 #endif // TA_TILEMAP_H
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <map>
 #include <cmath>
 #include "SDL3/SDL.h"
 #include "geometry.h"
@@ -22,9 +23,15 @@ enum TA_FunctionButton {
     TA_BUTTON_PAUSE,
     TA_BUTTON_LB,
     TA_BUTTON_RB,
+    TA_BUTTON_REWIND,
     TA_BUTTON_MAX
 };
 
+struct TA_InputState {
+    TA_Point direction;
+    int pressed = 0, justPressed = 0; // bit per TA_FunctionButton
+};
+
 namespace TA
 {
     extern SDL_Window *window;
@@ -32,11 +39,18 @@ namespace TA
 
     extern int screenWidth, screenHeight, scaleFactor;
     extern double elapsedTime;
+    // simulation steps done so far, and how far the drawn frame is between the last two of them (0..1)
+    extern long long tickCount;
+    extern double interpolation;
+    extern bool stepping; // positions set outside of a step (while drawing) aren't interpolated
+    extern bool headless; // --headless: no window, draw calls render nothing
+    extern int renderResetCount; // render target contents were lost this many times, e.g. on Android resume
 
     const double pi = atan(double(1)) * 4;
 
     extern std::string levelPath, previousLevelPath;
     extern std::set<std::string> arguments;
+    extern std::map<std::string, std::string> argumentValues; // argument following each one, e.g. the file of --record
 
     void drawRect(TA_Point topLeft, TA_Point bottomRight, int r, int g, int b, int a);
     void drawScreenRect(int r, int g, int b, int a);
@@ -53,6 +67,22 @@ namespace TA
         void init(unsigned long long seed);
         long long next();
         long long max();
+        unsigned long long getState();
+        void setState(unsigned long long state);
+    }
+
+    // --record <file> logs the seed, frame times and controller input of every step, --replay <file> plays a log back
+    namespace eventLog
+    {
+        // returns the seed to use, the logged one when replaying
+        unsigned long long init(unsigned long long seed);
+        bool isActive(); // TA_Controller reads getInput() instead of the devices
+        bool isReplaying();
+        // log the value or replace it with the logged one, false when the replay is over
+        bool updateFrame(double &frameTime);
+        bool updateStep(TA_InputState &input);
+        const TA_InputState &getInput();
+        void quit();
     }
 }
 
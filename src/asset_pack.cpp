@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include "asset_pack.h"
+#include "filesystem.h"
+#include "error.h"
+#include "tools.h"
+
+namespace TA::assetPack {
+    TA_MappedFile file;
+    std::vector<TA_AssetPackEntry> entries;
+
+    std::string_view getName(const TA_AssetPackEntry &entry);
+    void dropStaleEntries(const std::string &path);
+}
+
+void TA::assetPack::init()
+{
+    #ifdef __ANDROID__
+        // assets are compressed inside the APK and can't be mapped, reading the whole pack would only cost memory
+        return;
+    #endif
+    // baking writes loose files and must read them back
+    if(TA::arguments.count("--loose-assets") || TA::arguments.count("--bake-levels")) {
+        return;
+    }
+
+    std::string path = TA::filesystem::getAssetsPath() + ".pak";
+    if(!file.open(path)) {
+        return;
+    }
+
+    std::string_view data = file.getData();
+    TA_AssetPackHeader header;
+    bool valid = data.size() >= sizeof(header);
+    if(valid) {
+        std::memcpy(&header, data.data(), sizeof(header));
+        valid = std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version &&
+            header.count <= (data.size() - sizeof(header)) / sizeof(TA_AssetPackEntry);
+    }
+    if(valid) {
+        entries.resize(header.count);
+        std::memcpy(entries.data(), data.data() + sizeof(header), header.count * sizeof(TA_AssetPackEntry));
+        for(const TA_AssetPackEntry &entry : entries) {
+            if(entry.nameOffset > data.size() || entry.nameLength > data.size() - entry.nameOffset ||
+                entry.dataOffset > data.size() || entry.dataSize > data.size() - entry.dataOffset) {
+                valid = false;
+                break;
+            }
+        }
+    }
+
+    if(!valid) {
+        TA::printWarning("%s is not a valid asset pack, using loose files", path.c_str());
+        quit();
+        return;
+    }
+    dropStaleEntries(path);
+}
+
+void TA::assetPack::dropStaleEntries(const std::string &path)
+{
+    // loose files edited after the pack was built win over their packed copies, getAsset then misses them;
+    // installs built with the pack ship no loose assets, so this walks an empty or missing directory
+    std::error_code error;
+    std::filesystem::file_time_type packTime = std::filesystem::last_write_time(path, error);
+    std::filesystem::path assetsPath = TA::filesystem::getAssetsPath();
+    if(error || !std::filesystem::is_directory(assetsPath, error)) {
+        return;
+    }
+
+    std::vector<std::string> newer;
+    for(std::filesystem::recursive_directory_iterator iterator(assetsPath, error), end; !error && iterator != end; iterator.increment(error)) {
+        std::error_code fileError;
+        if(iterator->is_regular_file(fileError) && iterator->last_write_time(fileError) > packTime && !fileError) {
+            newer.push_back(std::filesystem::relative(iterator->path(), assetsPath, fileError).generic_string());
+        }
+    }
+    std::sort(newer.begin(), newer.end());
+
+    size_t count = entries.size();
+    std::erase_if(entries, [&](const TA_AssetPackEntry &entry) {
+        return std::binary_search(newer.begin(), newer.end(), getName(entry));
+    });
+    if(entries.size() != count) {
+        TA::printWarning("%i loose files are newer than %s, using them instead", int(count - entries.size()), path.c_str());
+    }
+}
+
+bool TA::assetPack::isOpen()
+{
+    return !entries.empty();
+}
+
+std::string_view TA::assetPack::getName(const TA_AssetPackEntry &entry)
+{
+    return file.getData().substr(entry.nameOffset, entry.nameLength);
+}
+
+std::string_view TA::assetPack::getAsset(std::string_view filename)
+{
+    auto entry = std::lower_bound(entries.begin(), entries.end(), filename, [](const TA_AssetPackEntry &entry, std::string_view name) {
+        return getName(entry) < name;
+    });
+    if(entry == entries.end() || getName(*entry) != filename) {
+        return {};
+    }
+    return file.getData().substr(entry->dataOffset, entry->dataSize);
+}
+
+void TA::assetPack::quit()
+{
+    entries.clear();
+    file.close();
+}
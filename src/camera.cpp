@@ -6,6 +6,7 @@ void TA_Camera::setFollowPosition(TA_Point *newFollowPosition)
 {
     updateOffset();
     followPosition = newFollowPosition;
+    updateTick = -1; // jumps aren't interpolated
 
     if(!lockedX) {
         position.x = (*followPosition).x;
@@ -28,8 +29,18 @@ void TA_Camera::forceLockX()
     lockedX = true;
 }
 
+TA_Point TA_Camera::getDrawPosition()
+{
+    if(updateTick != TA::tickCount) {
+        return getPosition();
+    }
+    return previousPosition + (getPosition() - previousPosition) * TA::interpolation;
+}
+
 void TA_Camera::update(bool ground, bool spring)
 {
+    previousPosition = getPosition();
+    updateTick = TA::tickCount;
     updateOffset();
     double movementSpeed = airSpeed;
     if(ground) {
@@ -118,3 +129,13 @@ void TA_Camera::updateOffset()
         yBottomOffset = 16;
     }
 }
+
+void TA_Camera::serialize(TA_StateBuffer &buffer)
+{
+    buffer.sync(position, lockPosition, shakeDelta, border, yTopOffset, yBottomOffset);
+    buffer.sync(locked, lockedX, lockedY, shakeTime);
+    if(buffer.isReading()) {
+        previousPosition = position;
+        updateTick = -1;
+    }
+}
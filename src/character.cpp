@@ -22,18 +22,19 @@ void TA_Character::load(TA_Links newLinks)
 
     TA_Pawn::load("tails/tails.png", 48, 48);
     loadAnimationsFromFile("tails/animations.xml");
+    loadAnimationIds();
     setCamera(links.camera);
 
     remoteRobotControlSprite.load("tails/tails.png", 48, 48);
     remoteRobotControlSprite.loadAnimationsFromFile("tails/animations.xml");
     remoteRobotControlSprite.setAnimation("control_remote_robot");
     remoteRobotControlSprite.setCamera(links.camera);
-    rings = TA::save::getSaveParameter("rings");
+    rings = TA::save::getSaveParameter(ringsParameter);
 }
 
 void TA_Character::handleInput()
 {
-    rings = TA::save::getSaveParameter("rings");
+    rings = TA::save::getSaveParameter(ringsParameter);
     hidden = nextFrameHidden;
     if(hidden) {
         return;
@@ -49,7 +50,9 @@ void TA_Character::handleInput()
 
     physicsStep();
     double prevX = position.x;
+    links.objectSet->beginCollisionContext(getCollisionContextBounds());
     updateCollisions();
+    links.objectSet->endCollisionContext();
     deltaX = position.x - prevX;
 
     windVelocity = {0, 0};
@@ -58,7 +61,7 @@ void TA_Character::handleInput()
 
 void TA_Character::update()
 {
-    rings = TA::save::getSaveParameter("rings");
+    rings = TA::save::getSaveParameter(ringsParameter);
     if(hidden) {
         return;
     }
@@ -151,6 +154,28 @@ void TA_Character::draw()
     TA_Pawn::draw();
 }
 
+void TA_Character::loadAnimationIds()
+{
+    animationIds.idle = getAnimationId("idle");
+    animationIds.walk = getAnimationId("walk");
+    animationIds.push = getAnimationId("push");
+    animationIds.lookUp = getAnimationId("look_up");
+    animationIds.crouch = getAnimationId("crouch");
+    animationIds.hurt = getAnimationId("hurt");
+    animationIds.fall = getAnimationId("fall");
+    animationIds.jumpUp = getAnimationId("jump_up");
+    animationIds.jumpDown = getAnimationId("jump_down");
+    animationIds.helitail = getAnimationId("helitail");
+    animationIds.helitailFull = getAnimationId("helitail_full");
+    animationIds.helitailTired = getAnimationId("helitail_tired");
+    animationIds.throwHelitail = getAnimationId("throw_helitail");
+    animationIds.throwAir = getAnimationId("throw_air");
+    animationIds.release = getAnimationId("release");
+    animationIds.remoteRobotIdle = getAnimationId("remote_robot_idle");
+    animationIds.remoteRobotWalk = getAnimationId("remote_robot_walk");
+    animationIds.remoteRobotFlyLoop = getAnimationId("remote_robot_fly_loop");
+}
+
 void TA_Character::updateAnimation()
 {
     if(rings >= 0 && hurt) {
@@ -167,67 +192,67 @@ void TA_Character::updateAnimation()
         setAlpha(255);
         if(helitail) {
             if(!isAnimated()) {
-                setAnimation("remote_robot_fly_loop");
+                setAnimationById(animationIds.remoteRobotFlyLoop);
             }
         }
         else if(ground && !TA::equal(velocity.x, 0)) {
-            setAnimation("remote_robot_walk");
+            setAnimationById(animationIds.remoteRobotWalk);
         }
         else {
-            setAnimation("remote_robot_idle");
+            setAnimationById(animationIds.remoteRobotIdle);
         }
         return;
     }
 
     if(hurt) {
-        setAnimation("hurt");
+        setAnimationById(animationIds.hurt);
     }
     else if(ground) {
         if(lookUp) {
-            setAnimation("look_up");
+            setAnimationById(animationIds.lookUp);
         }
         else if(crouch) {
-            setAnimation("crouch");
+            setAnimationById(animationIds.crouch);
         }
         else if(TA::equal(velocity.x, 0)) {
-            setAnimation("idle");
+            setAnimationById(animationIds.idle);
         }
         else if(wall) {
-            setAnimation("push");
+            setAnimationById(animationIds.push);
         }
         else {
-            setAnimation("walk");
+            setAnimationById(animationIds.walk);
         }
     }
     else {
         if(helitail) {
-            if(getAnimationName() != "throw_helitail") {
+            if(!isPlayingAnimation(animationIds.throwHelitail)) {
                 double maxTime = getMaxHelitailTime();
                 if(helitailTime < maxTime / 3) {
-                    setAnimation("helitail_full");
+                    setAnimationById(animationIds.helitailFull);
                 }
                 else if(helitailTime < maxTime * 2 / 3) {
-                    setAnimation("helitail");
+                    setAnimationById(animationIds.helitail);
                 }
                 else {
-                    setAnimation("helitail_tired");
+                    setAnimationById(animationIds.helitailTired);
                 }
             }
         }
         else if(jump) {
             if(velocity.y < 0) {
-                setAnimation("jump_up");
+                setAnimationById(animationIds.jumpUp);
             }
             else {
-                setAnimation("jump_down");
+                setAnimationById(animationIds.jumpDown);
             }
         }
-        else if(getAnimationName() != "throw_air") {
+        else if(!isPlayingAnimation(animationIds.throwAir)) {
             if(coyoteTime < maxCoyoteTime) {
-                setAnimation("jump_down");
+                setAnimationById(animationIds.jumpDown);
             }
             else {
-                setAnimation("fall");
+                setAnimationById(animationIds.fall);
             }
         }
     }
@@ -394,3 +419,15 @@ void TA_Character::setPaused(bool paused)
     setUpdateAnimation(!paused);
     remoteRobotControlSprite.setUpdateAnimation(!paused);
 }
+
+void TA_Character::serialize(TA_StateBuffer &buffer)
+{
+    TA_Pawn::serialize(buffer);
+    remoteRobotControlSprite.serialize(buffer);
+    buffer.sync(followPosition, velocity, climbPosition, hitbox, hammerHitbox, topLeft, bottomRight, windVelocity);
+    buffer.sync(state, remoteRobotInitialPosition, ground, helitail, wall, ceiling, flip, jump, jumpReleased, spring);
+    buffer.sync(hurt, lookUp, crouch, useSolidUpTiles, useSolidDownTiles, useMovingPlatforms, remoteRobot);
+    buffer.sync(bombDestroySignal, strongWind, hidden, nextFrameHidden, water);
+    buffer.sync(jumpSpeed, jumpTime, climbTime, helitailTime, invincibleTimeLeft, timer, lookTime, teleportTime);
+    buffer.sync(coyoteTime, deltaX, rings, currentTool, usingSpeedBoots);
+}
@@ -1,3 +1,4 @@
+#include <cmath>
 #include "character.h"
 #include "object_set.h"
 #include "error.h"
@@ -8,21 +9,35 @@
 
 bool TA_Character::checkPawnCollision(TA_Polygon &checkHitbox)
 {
-    int flags = 0;
-    links.objectSet->checkCollision(checkHitbox, flags);
-    if((flags & (TA_COLLISION_SOLID | TA_COLLISION_PUSHABLE)) != 0) {
-        return true;
-    }
-    if(useSolidUpTiles && (flags & TA_COLLISION_SOLID_UP) != 0) {
-        return true;
+    return links.objectSet->checkCollisionTypes(checkHitbox, getSolidCollisionMask()) != 0;
+}
+
+int TA_Character::getSolidCollisionMask()
+{
+    int mask = TA_COLLISION_SOLID | TA_COLLISION_PUSHABLE;
+    if(useSolidUpTiles) {
+        mask |= TA_COLLISION_SOLID_UP;
     }
-    if(useSolidDownTiles && (flags & TA_COLLISION_SOLID_DOWN) != 0) {
-        return true;
+    if(useSolidDownTiles) {
+        mask |= TA_COLLISION_SOLID_DOWN;
     }
-    if(useMovingPlatforms && (flags & TA_COLLISION_MOVING_PLATFORM) != 0) {
-        return true;
+    if(useMovingPlatforms) {
+        mask |= TA_COLLISION_MOVING_PLATFORM;
     }
-    return false;
+    return mask;
+}
+
+void TA_Character::addCollisionCandidates(TA_Rect bounds, std::vector<TA_CollisionHitbox> &candidates)
+{
+    links.objectSet->addCollisionCandidates(bounds, getSolidCollisionMask(), candidates);
+}
+
+TA_Rect TA_Character::getCollisionContextBounds()
+{
+    // covers every hitbox used in updateCollisions, including climb checks and conveyor belts
+    TA_Point delta = (velocity + windVelocity) * TA::elapsedTime;
+    TA_Point margin(std::abs(delta.x) + collisionContextMargin, std::abs(delta.y) + collisionContextMargin);
+    return {position + TA_Point(16, 9) - margin, position + TA_Point(32, 39) + margin};
 }
 
 void TA_Character::updateCollisions()
@@ -314,7 +329,7 @@ void TA_Character::updateSpringCollision()
     hitbox.setPosition(position);
     hitbox.setRectangle({topLeft.x + 0.01, bottomRight.y}, bottomRight + TA_Point(-0.01, 0.01));
 
-    if(links.objectSet->checkCollision(hitbox) & TA_COLLISION_SPRING) {
+    if(links.objectSet->checkCollisionTypes(hitbox, TA_COLLISION_SPRING)) {
         jumpSound.play();
         jumpSpeed = springYsp;
         jump = spring = true;
@@ -330,7 +345,7 @@ void TA_Character::updateWaterCollision()
     hitbox.setPosition(position);
     hitbox.setRectangle(topLeft, bottomRight);
 
-    bool newWater = (links.objectSet->checkCollision(hitbox) & TA_COLLISION_WATER);
+    bool newWater = (links.objectSet->checkCollisionTypes(hitbox, TA_COLLISION_WATER));
     if(water != newWater && newWater == (velocity.y > 0) && !ground) {
         links.objectSet->spawnObject<TA_Splash>(position + TA_Point(14, 22));
         waterSound.play();
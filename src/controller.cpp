@@ -39,6 +39,9 @@ void TA_Controller::draw()
 
 TA_Point TA_Controller::getDirectionVector()
 {
+    if(TA::eventLog::isActive()) {
+        return TA::eventLog::getInput().direction;
+    }
     for(TA_Point vector : {onscreen.getDirectionVector(), gamepad.getDirectionVector()}) {
         if(vector.length() >= analogDeadZone) {
             return vector;
@@ -68,11 +71,17 @@ TA_Direction TA_Controller::getDirection()
 
 bool TA_Controller::isPressed(TA_FunctionButton button)
 {
+    if(TA::eventLog::isActive()) {
+        return TA::eventLog::getInput().pressed & (1 << button);
+    }
     return keyboard.isPressed(button) || gamepad.isPressed(button) || onscreen.isPressed(button);
 }
 
 bool TA_Controller::isJustPressed(TA_FunctionButton button)
 {
+    if(TA::eventLog::isActive()) {
+        return TA::eventLog::getInput().justPressed & (1 << button);
+    }
     return keyboard.isJustPressed(button) || gamepad.isJustPressed(button) || onscreen.isJustPressed(button);
 }
 
@@ -84,3 +93,21 @@ bool TA_Controller::isTouchscreen()
         return false;
     #endif
 }
+
+TA_InputState TA_Controller::getDeviceInput()
+{
+    TA_InputState input;
+    TA_Point vector = TA::gamepad::getDirectionVector();
+    input.direction = (vector.length() >= analogDeadZone ? vector : TA::keyboard::getDirectionVector());
+
+    for(int pos = 0; pos < TA_BUTTON_MAX; pos ++) {
+        TA_FunctionButton button = TA_FunctionButton(pos);
+        if(TA::keyboard::isPressed(button) || TA::gamepad::isPressed(button)) {
+            input.pressed |= (1 << pos);
+        }
+        if(TA::keyboard::isJustPressed(button) || TA::gamepad::isJustPressed(button)) {
+            input.justPressed |= (1 << pos);
+        }
+    }
+    return input;
+}
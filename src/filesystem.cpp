@@ -10,6 +10,13 @@
 #include <unistd.h>
 #endif
 
+#if !defined(_WIN32) && !defined(__ANDROID__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 void TA::filesystem::fixPath(std::string &path)
 {
     // SDL Android assets access breaks when adding ./ for some reason, so I'll just remove them
@@ -42,15 +49,8 @@ std::string TA::filesystem::readFile(std::string path)
 
     size_t dataBytes = SDL_SeekIO(file, 0, SDL_IO_SEEK_END);
     SDL_SeekIO(file, 0, SDL_IO_SEEK_SET);
-    char* data = new char[dataBytes];
-    SDL_ReadIO(file, data, dataBytes);
-
-    std::string str(dataBytes + 1, 0);
-    for(int pos = 0; pos < dataBytes; pos ++) {
-        str[pos] = data[pos];
-    }
-    str[dataBytes] = '\0';
-    delete[] data;
+    std::string str(dataBytes, '\0');
+    SDL_ReadIO(file, str.data(), dataBytes);
 
     if(!SDL_CloseIO(file)) {
         TA::handleSDLError("Close %s after reading failed", path.c_str());
@@ -106,3 +106,76 @@ void TA::filesystem::writeFile(std::string path, std::string value)
         TA::handleSDLError("Close %s after writing failed", path.c_str());
     }
 }
+
+bool TA_MappedFile::open(std::string path)
+{
+    close();
+    TA::filesystem::fixPath(path);
+
+    #ifdef __ANDROID__
+        if(!TA::filesystem::fileExists(path)) {
+            return false;
+        }
+        buffer = TA::filesystem::readFile(path);
+        data = buffer;
+    #elif defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        mappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        CloseHandle(file);
+        if(mappingHandle == NULL) {
+            return false;
+        }
+        mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if(mapping == NULL) {
+            close();
+            return false;
+        }
+        data = std::string_view(static_cast<const char*>(mapping), size.QuadPart);
+    #else
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if(descriptor == -1) {
+            return false;
+        }
+        struct stat status;
+        if(fstat(descriptor, &status) == -1 || status.st_size == 0) {
+            ::close(descriptor);
+            return false;
+        }
+        mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);
+        if(mapping == MAP_FAILED) {
+            mapping = nullptr;
+            return false;
+        }
+        data = std::string_view(static_cast<const char*>(mapping), status.st_size);
+    #endif
+
+    return true;
+}
+
+void TA_MappedFile::close()
+{
+    #ifdef _WIN32
+        if(mapping != nullptr) {
+            UnmapViewOfFile(mapping);
+        }
+        if(mappingHandle != nullptr) {
+            CloseHandle(mappingHandle);
+        }
+    #elif !defined(__ANDROID__)
+        if(mapping != nullptr) {
+            munmap(mapping, data.size());
+        }
+    #endif
+    mapping = mappingHandle = nullptr;
+    buffer.clear();
+    data = {};
+}
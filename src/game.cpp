@@ -11,27 +11,57 @@
 #include "tools.h"
 #include "gamepad.h"
 #include "resource_manager.h"
+#include "asset_pack.h"
 #include "keyboard.h"
 #include "save.h"
+#include "pawn.h"
+#include "object_set.h"
+#include "level_file.h"
+#include "rewind_buffer.h"
+#include "controller.h"
 
 TA_Game::TA_Game()
 {
+    TA::headless = TA::arguments.count("--headless");
+    TA::assetPack::init();
     TA::save::load();
     initSDL();
     createWindow();
-    TA::random::init(std::chrono::steady_clock::now().time_since_epoch().count());
+    TA::sound::init();
+    TA::keyboard::init();
+    TA::random::init(TA::eventLog::init(std::chrono::steady_clock::now().time_since_epoch().count()));
+    if(TA::arguments.count("--sweep-collision")) {
+        TA_Pawn::setCollisionSolver(TA_PAWN_SOLVER_SWEEP);
+    }
+    else if(TA::arguments.count("--check-collision-solver")) {
+        TA_Pawn::setCollisionSolver(TA_PAWN_SOLVER_SWEEP_CHECKED);
+    }
     TA::gamepad::init();
     TA::resmgr::preload();
 
     font.load("fonts/pause_menu.png", 8, 8);
     font.setMapping("abcdefghijklmnopqrstuvwxyz AB.?-0123456789CDEF%:+");
 
-    startTime = std::chrono::high_resolution_clock::now();
+    startTime = simulationStartTime = std::chrono::high_resolution_clock::now();
     screenStateMachine.init();
+
+    if(TA::arguments.count("--bake-levels")) {
+        TA::levelFile::bakeLevels();
+        quitNeeded = true;
+    }
+    if(TA::arguments.count("--check-collision-scenes")) {
+        TA_Pawn::checkSolversOnScenes();
+        quitNeeded = true;
+    }
 }
 
 void TA_Game::initSDL()
 {
+    if(TA::headless) {
+        // no display or sound device is needed
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+    }
     if(!SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_HAPTIC | SDL_INIT_GAMEPAD | SDL_INIT_EVENTS | SDL_INIT_SENSOR)) {
         TA::handleSDLError("%s", "SDL init failed");
     }
@@ -50,6 +80,19 @@ void TA_Game::initSDL()
 
 void TA_Game::createWindow()
 {
+    if(TA::headless) {
+        // textures are still needed for sprite sizes, a software renderer without a window creates them
+        windowWidth = baseHeight * 16 / 9;
+        windowHeight = baseHeight;
+        headlessSurface = SDL_CreateSurface(windowWidth, windowHeight, SDL_PIXELFORMAT_RGBA8888);
+        TA::renderer = SDL_CreateSoftwareRenderer(headlessSurface);
+        if(TA::renderer == nullptr) {
+            TA::handleSDLError("%s", "Failed to create renderer");
+        }
+        updateWindowSize();
+        return;
+    }
+
     TA::window = SDL_CreateWindow("Tails Adventure", defaultWindowWidth, defaultWindowHeight, SDL_WINDOW_FULLSCREEN);
     if(TA::window == nullptr) {
         TA::handleSDLError("%s", "Failed to create window");
@@ -61,13 +104,27 @@ void TA_Game::createWindow()
     }
 
     updateWindowSize();
+    updateVSync();
     SDL_SetRenderDrawBlendMode(TA::renderer, SDL_BLENDMODE_BLEND);
-    int vsync = TA::save::getParameter("vsync");
+
+    // the window also changes on resize events, see process()
+    for(TA_ParameterHandle handle : {pixelARParameter, resolutionParameter, scaleModeParameter}) {
+        TA::save::addListener(handle, [this] {updateWindowSize();});
+    }
+    TA::save::addListener(vsyncParameter, [this] {updateVSync();});
+}
+
+void TA_Game::updateVSync()
+{
+    int vsync = TA::save::getParameter(vsyncParameter);
     SDL_SetRenderVSync(TA::renderer, (vsync == 2 ? -1 : vsync));
 }
 
 void TA_Game::toggleFullscreen()
 {
+    if(TA::window == nullptr) {
+        return;
+    }
     fullscreen = !fullscreen;
     SDL_SetWindowFullscreen(TA::window, fullscreen);
     updateWindowSize();
@@ -75,16 +132,17 @@ void TA_Game::toggleFullscreen()
 
 void TA_Game::updateWindowSize()
 {
-    double pixelAR = (TA::save::getParameter("pixel_ar") == 0 ? 1 : double(7) / 8);
+    double pixelAR = (TA::save::getParameter(pixelARParameter) == 0 ? 1 : double(7) / 8);
 
-    if(!fullscreen) {
-        int factor = TA::save::getParameter("resolution");
-        int neededWidth = baseHeight * 16 / 9 * factor;
-        int neededHeight = baseHeight * factor;
-        SDL_SetWindowSize(TA::window, neededWidth, neededHeight);
+    if(TA::window != nullptr) {
+        if(!fullscreen) {
+            int factor = TA::save::getParameter(resolutionParameter);
+            int neededWidth = baseHeight * 16 / 9 * factor;
+            int neededHeight = baseHeight * factor;
+            SDL_SetWindowSize(TA::window, neededWidth, neededHeight);
+        }
+        SDL_GetWindowSize(TA::window, &windowWidth, &windowHeight);
     }
-
-    SDL_GetWindowSize(TA::window, &windowWidth, &windowHeight);
     TA::screenWidth = baseHeight * windowWidth / windowHeight * pixelAR;
     TA::screenHeight = baseHeight;
     TA::scaleFactor = (windowWidth + TA::screenWidth - 1) / TA::screenWidth;
@@ -99,17 +157,15 @@ void TA_Game::updateWindowSize()
         targetTexture = SDL_CreateTexture(TA::renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, targetWidth, targetHeight);
     }
 
-    SDL_SetTextureScaleMode(targetTexture, TA::save::getParameter("scale_mode") ? SDL_SCALEMODE_LINEAR : SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureScaleMode(targetTexture, TA::save::getParameter(scaleModeParameter) ? SDL_SCALEMODE_LINEAR : SDL_SCALEMODE_NEAREST);
 }
 
 bool TA_Game::process()
 {
-    updateWindowSize();
+    if(quitNeeded) {
+        return false;
+    }
 
-    TA::touchscreen::update();
-    TA::keyboard::update();
-    TA::gamepad::update();
-    TA::sound::update();
     SDL_Event event;
 
     while(SDL_PollEvent(&event)) {
@@ -122,44 +178,126 @@ bool TA_Game::process()
         else if(event.type == SDL_EVENT_GAMEPAD_ADDED || event.type == SDL_EVENT_GAMEPAD_REMOVED) {
             TA::gamepad::handleEvent(event.gdevice);
         }
+        else if(event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) {
+            updateWindowSize();
+        }
+        else if(event.type == SDL_EVENT_RENDER_TARGETS_RESET || event.type == SDL_EVENT_RENDER_DEVICE_RESET) {
+            TA::renderResetCount ++;
+        }
+    }
+
+    if(screenStateMachine.isQuitNeeded()) {
+        return false;
     }
+    return true;
+}
+
+bool TA_Game::step(double elapsedTime)
+{
+    TA::elapsedTime = elapsedTime;
+    TA::tickCount ++;
 
+    // input is sampled per step, so a press is seen exactly once however many steps a frame has
+    TA::keyboard::update();
+    TA::gamepad::update();
     if(TA::keyboard::isScancodePressed(SDL_SCANCODE_RALT) && TA::keyboard::isScancodePressed(SDL_SCANCODE_RETURN) &&
         (TA::keyboard::isScancodeJustPressed(SDL_SCANCODE_RALT) || TA::keyboard::isScancodeJustPressed(SDL_SCANCODE_RETURN))) {
         toggleFullscreen();
     }
-    if(screenStateMachine.isQuitNeeded()) {
-        return false;
+    if(TA::eventLog::isActive()) {
+        TA_InputState input = TA_Controller::getDeviceInput();
+        if(!TA::eventLog::updateStep(input)) {
+            quitNeeded = true;
+        }
     }
-    return true;
+
+    TA::stepping = true;
+    bool screenChanged = screenStateMachine.update();
+    TA::stepping = false;
+    // touches are collected from events in process(), keep them until a step has seen them
+    TA::touchscreen::update();
+    return screenChanged;
 }
 
 void TA_Game::update()
 {
     currentTime = std::chrono::high_resolution_clock::now();
-    TA::elapsedTime = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(currentTime - startTime).count()) / 1e6 * 60;
+    double frameTime = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(currentTime - startTime).count()) / 1e6 * 60;
 
-    TA::elapsedTime = std::min(TA::elapsedTime, maxElapsedTime);
-    //TA::elapsedTime /= 10;
+    frameTime = std::min(frameTime, maxElapsedTime);
+    //frameTime /= 10;
     startTime = currentTime;
+    if(TA::headless) {
+        // run as fast as possible, one step per frame
+        frameTime = 1;
+    }
+    // a replay also repeats the frame times, so frames get the same steps and animations the same time
+    if(!TA::eventLog::updateFrame(frameTime)) {
+        quitNeeded = true;
+        return;
+    }
 
-    SDL_SetRenderTarget(TA::renderer, targetTexture);
-    SDL_SetRenderDrawColor(TA::renderer, 0, 0, 0, 255);
-    SDL_RenderClear(TA::renderer);
+    TA::resmgr::update();
+
+    if(!TA::headless) {
+        SDL_SetRenderTarget(TA::renderer, targetTexture);
+        SDL_SetRenderDrawColor(TA::renderer, 0, 0, 0, 255);
+        SDL_RenderClear(TA::renderer);
+    }
 
-    if(screenStateMachine.update()) {
+    bool screenChanged = false;
+    if(screenStateMachine.isFixedStep()) {
+        // one step is 1/60 s, TA::elapsedTime is 1 in every step
+        accumulator += frameTime;
+        int steps = 0;
+        while(accumulator >= 1 && !screenChanged) {
+            accumulator -= 1;
+            screenChanged = step(1);
+            steps ++;
+        }
+        // drawing advances animations by the simulated time
+        TA::elapsedTime = steps;
+        TA::interpolation = std::min(accumulator, double(1));
+    }
+    else {
+        screenChanged = step(frameTime);
+        TA::interpolation = 1;
+    }
+
+    if(screenChanged) {
+        // a new screen gets a step before it's drawn
+        accumulator = 1;
+        TA::interpolation = 1;
         startTime = std::chrono::high_resolution_clock::now();
     }
+    // headless too, drawing advances animations
+    screenStateMachine.draw();
+    if(TA::headless) {
+        return;
+    }
 
-    if(TA::save::getParameter("frame_time")) {
+    if(TA::save::getParameter(frameTimeParameter)) {
         int frameTime = static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>((std::chrono::high_resolution_clock::now() - startTime)).count());
         frameTimeSum += frameTime;
         frame += 1;
         if(frame % 60 == 0) {
             prevFrameTime = frameTimeSum / 60;
             frame = frameTimeSum = 0;
+            avoidedQueriesPerFrame = (TA_ObjectSet::getAvoidedQueries() - prevAvoidedQueries) / 60;
+            prevAvoidedQueries = TA_ObjectSet::getAvoidedQueries();
+            captureTimePerFrame = (TA_RewindBuffer::getCaptureTime() - prevCaptureTime) / 60;
+            prevCaptureTime = TA_RewindBuffer::getCaptureTime();
         }
+        // labeled lines end where a four digit frame time does
+        auto drawStat = [&](double y, std::string label, long long value) {
+            std::string text = label + " " + std::to_string(value);
+            font.drawText(TA_Point(TA::screenWidth - 4 - font.getTextWidth(text), y), text);
+        };
         font.drawText(TA_Point(TA::screenWidth - 36, 24), std::to_string(prevFrameTime));
+        drawStat(36, "q", avoidedQueriesPerFrame);
+        // rewind buffer: microseconds of capturing per frame, memory in KiB
+        drawStat(48, "cap", captureTimePerFrame);
+        drawStat(60, "kb", TA_RewindBuffer::getMemoryUsage() / 1024);
     }
 
     SDL_SetRenderTarget(TA::renderer, nullptr);
@@ -174,12 +312,20 @@ void TA_Game::update()
 
 TA_Game::~TA_Game()
 {
+    if(TA::headless) {
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - simulationStartTime).count();
+        TA::printLog("%lld ticks in %.2f s (%.0f ticks/s), level %s, random state %llu", TA::tickCount, seconds,
+            TA::tickCount / std::max(seconds, 1e-6), TA::levelPath.c_str(), TA::random::getState());
+    }
+    TA::eventLog::quit();
     TA::gamepad::quit();
     TA::resmgr::quit();
+    TA::assetPack::quit();
 
     SDL_DestroyTexture(targetTexture);
     SDL_DestroyRenderer(TA::renderer);
     SDL_DestroyWindow(TA::window);
+    SDL_DestroySurface(headlessSurface);
 
     Mix_CloseAudio();
     Mix_Quit();
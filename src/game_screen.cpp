@@ -1,5 +1,8 @@
+#include <chrono>
 #include "game_screen.h"
 #include "save.h"
+#include "error.h"
+#include "tools.h"
 
 void TA_GameScreen::init()
 {
@@ -29,10 +32,22 @@ void TA_GameScreen::init()
     }
     
     objectSet.setLinks(links);
-    tilemap.load(TA::levelPath + ".tmx");
+    TA_LevelFile levelFile;
+    bool baked = levelFile.open(TA::levelPath);
+    if(baked) {
+        tilemap.load(levelFile);
+    }
+    else {
+        tilemap.load(TA::levelPath + ".tmx");
+    }
     tilemap.setCamera(&camera);
     hud.load(links);
-    objectSet.load(TA::levelPath + ".xml");
+    if(baked) {
+        objectSet.load(levelFile);
+    }
+    else {
+        objectSet.load(TA::levelPath + ".xml");
+    }
 
     if(isSeaFox) {
         seaFox.setSpawnPoint(objectSet.getCharacterSpawnPoint(), objectSet.getCharacterSpawnFlip());
@@ -42,13 +57,22 @@ void TA_GameScreen::init()
     }
     
     TA::previousLevelPath = TA::levelPath;
-    timer = TA::save::getSaveParameter("time");
+    timer = TA::save::getSaveParameter(timeParameter);
+    rewindBuffer.setCapacity(std::max(0ll, TA::save::getParameter("rewind_seconds")) * 60);
+    checkingSnapshots = TA::arguments.count("--check-snapshots");
 }
 
 TA_ScreenState TA_GameScreen::update()
 {
+    if(checkingSnapshots) {
+        checkSnapshot();
+    }
+    if(updateRewind()) {
+        return TA_SCREENSTATE_CURRENT;
+    }
+
     timer += TA::elapsedTime;
-    TA::save::setSaveParameter("time", timer);
+    TA::save::setSaveParameter(timeParameter, timer);
 
     controller.update();
     hud.update();
@@ -79,6 +103,23 @@ TA_ScreenState TA_GameScreen::update()
     tilemap.setUpdateAnimation(!hud.isPaused());
     objectSet.setPaused(hud.isPaused());
 
+    if(hud.getTransition() != TA_SCREENSTATE_CURRENT) {
+        return hud.getTransition();
+    }
+    if((!isSeaFox && character.gameOver()) || (isSeaFox && seaFox.gameOver())) {
+        return TA_SCREENSTATE_GAMEOVER;
+    }
+    if(!isSeaFox && character.isTeleported()) {
+        return TA_SCREENSTATE_HOUSE;
+    }
+    if(objectSet.getTransition() != TA_SCREENSTATE_CURRENT) {
+        return objectSet.getTransition();
+    }
+    return TA_SCREENSTATE_CURRENT;
+}
+
+void TA_GameScreen::draw()
+{
     tilemap.draw(0);
     objectSet.draw(0);
 
@@ -94,23 +135,90 @@ TA_ScreenState TA_GameScreen::update()
     objectSet.draw(2);
     hud.draw();
     controller.draw();
+}
 
-    if(hud.getTransition() != TA_SCREENSTATE_CURRENT) {
-        return hud.getTransition();
-    }
-    if((!isSeaFox && character.gameOver()) || (isSeaFox && seaFox.gameOver())) {
-        return TA_SCREENSTATE_GAMEOVER;
+void TA_GameScreen::quit()
+{
+
+}
+
+void TA_GameScreen::saveState(TA_Snapshot &snapshot)
+{
+    snapshot.buffer.startWriting();
+    snapshot.prototypes.clear();
+    serialize(snapshot);
+}
+
+void TA_GameScreen::loadState(TA_Snapshot &snapshot)
+{
+    snapshot.buffer.startReading();
+    serialize(snapshot);
+}
+
+void TA_GameScreen::serialize(TA_Snapshot &snapshot)
+{
+    TA_StateBuffer &buffer = snapshot.buffer;
+    unsigned long long randomState = TA::random::getState();
+    buffer.sync(randomState, timer);
+    if(buffer.isReading()) {
+        TA::random::setState(randomState);
     }
-    if(!isSeaFox && character.isTeleported()) {
-        return TA_SCREENSTATE_HOUSE;
+
+    TA::save::serializeCurrentSave(buffer);
+    tilemap.serialize(buffer);
+    camera.serialize(buffer);
+    controller.serialize(buffer);
+    if(isSeaFox) {
+        seaFox.serialize(buffer);
     }
-    if(objectSet.getTransition() != TA_SCREENSTATE_CURRENT) {
-        return objectSet.getTransition();
+    else {
+        character.serialize(buffer);
     }
-    return TA_SCREENSTATE_CURRENT;
+    hud.serialize(buffer);
+    objectSet.serialize(snapshot);
 }
 
-void TA_GameScreen::quit()
+bool TA_GameScreen::updateRewind()
 {
+    // recorded input doesn't include the rewind key, replays would go their own way
+    if(!rewindBuffer.isEnabled() || hud.isPaused() || TA::eventLog::isActive()) {
+        return false;
+    }
 
+    // holding the button steps back through the buffer at normal speed
+    if(controller.isPressed(TA_BUTTON_REWIND)) {
+        // the step is skipped, but onscreen buttons still have to see the touch end
+        controller.update();
+        if(rewindBuffer.pop(rewindSnapshot)) {
+            loadState(rewindSnapshot);
+        }
+        return true;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    saveState(rewindSnapshot);
+    rewindBuffer.push(rewindSnapshot);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    TA_RewindBuffer::addCaptureTime(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count());
+    return false;
+}
+
+void TA_GameScreen::checkSnapshot()
+{
+    // restoring a state must give back the same state
+    auto startTime = std::chrono::high_resolution_clock::now();
+    saveState(checkSnapshots[0]);
+    auto saveTime = std::chrono::high_resolution_clock::now();
+    loadState(checkSnapshots[0]);
+    auto loadTime = std::chrono::high_resolution_clock::now();
+    saveState(checkSnapshots[1]);
+
+    if(checkSnapshots[0].buffer.getData() != checkSnapshots[1].buffer.getData()) {
+        TA::printWarning("Snapshot at tick %lld doesn't restore to the same state", TA::tickCount);
+    }
+    if(TA::tickCount % 600 == 0) {
+        TA::printLog("Snapshot: %zu bytes, saved in %.3f ms, restored in %.3f ms", checkSnapshots[0].buffer.getData().size(),
+            std::chrono::duration<double, std::milli>(saveTime - startTime).count(),
+            std::chrono::duration<double, std::milli>(loadTime - saveTime).count());
+    }
 }
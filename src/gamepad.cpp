@@ -16,6 +16,7 @@ namespace TA::gamepad {
     std::array<bool, SDL_GAMEPAD_BUTTON_COUNT> pressed, justPressed;
     bool isConnected = false;
     bool isOncePressed = false;
+    bool listening = false;
 }
 
 bool TA::gamepad::connected()
@@ -52,6 +53,12 @@ void TA::gamepad::init(int index)
     }
     
     SDL_AddGamepadMappingsFromFile("gamecontrollerdb.txt");
+    if(!listening) {
+        for(std::string name : {"a", "b", "start", "lb", "rb", "rewind"}) {
+            TA::save::addListener(TA::save::getParameterHandle("gamepad_map_" + name), updateMapping);
+        }
+        listening = true;
+    }
     updateMapping();
 }
 
@@ -66,6 +73,7 @@ void TA::gamepad::updateMapping()
     mapping[TA_BUTTON_PAUSE] = getMap("start");
     mapping[TA_BUTTON_LB] = getMap("lb");
     mapping[TA_BUTTON_RB] = getMap("rb");
+    mapping[TA_BUTTON_REWIND] = getMap("rewind");
 
     directionMapping[TA_DIRECTION_UP] = SDL_GAMEPAD_BUTTON_DPAD_UP;
     directionMapping[TA_DIRECTION_DOWN] = SDL_GAMEPAD_BUTTON_DPAD_DOWN;
@@ -78,7 +86,6 @@ void TA::gamepad::update()
     if(!connected()) {
         return;
     }
-    updateMapping();
 
     for(int button = 0; button < SDL_GAMEPAD_BUTTON_COUNT; button ++) {
         if(SDL_GetGamepadButton(controller, (SDL_GamepadButton)button)) {
@@ -1,4 +1,86 @@
+#include <algorithm>
 #include "hitbox_container.h"
+#include "error.h"
+
+void TA_HitboxContainer::setSize(int newWidth, int newHeight, int newChunkSize)
+{
+    if(newChunkSize <= 0) {
+        TA::handleError("invalid hitbox container chunk size %i", newChunkSize);
+    }
+    chunkSize = newChunkSize;
+    width = std::max(1, (newWidth + chunkSize - 1) / chunkSize);
+    height = std::max(1, (newHeight + chunkSize - 1) / chunkSize);
+
+    chunks.assign(width * height, Chunk());
+    staticChunks.assign(width * height, Chunk());
+    elements.clear();
+    staticElements.clear();
+    freeStaticElements.clear();
+    staticTypeCounts.fill(0);
+    currentTime = collisionTypeMask = staticCollisionTypeMask = 0;
+    queryTime = 0;
+}
+
+void TA_HitboxContainer::getChunkRange(TA_Point topLeft, TA_Point bottomRight, int &left, int &top, int &right, int &bottom)
+{
+    // hitboxes outside of the map are kept in the border chunks
+    auto normalize = [&](double value, int count) {
+        return std::min(std::max(int(value / chunkSize), 0), count - 1);
+    };
+
+    left = normalize(topLeft.x, width);
+    right = normalize(bottomRight.x, width);
+    top = normalize(topLeft.y, height);
+    bottom = normalize(bottomRight.y, height);
+}
+
+template<typename Function>
+void TA_HitboxContainer::forEachElement(TA_Point topLeft, TA_Point bottomRight, int mask, Function function)
+{
+    if(((collisionTypeMask | staticCollisionTypeMask) & mask) == 0) {
+        return;
+    }
+
+    int left, top, right, bottom;
+    getChunkRange(topLeft, bottomRight, left, top, right, bottom);
+    queryTime ++;
+    if(queryTime == 0) [[unlikely]] {
+        for(Element &element : elements) {
+            element.queryTime = 0;
+        }
+        for(StaticElement &element : staticElements) {
+            element.queryTime = 0;
+        }
+        queryTime = 1;
+    }
+
+    auto processChunk = [&](Chunk &chunk, auto &chunkElements) {
+        if((chunk.typeMask & mask) == 0) {
+            return true;
+        }
+        for(int index : chunk.elements) {
+            Element &element = chunkElements[index];
+            if(element.queryTime == queryTime || (element.type & mask) == 0) {
+                continue;
+            }
+            element.queryTime = queryTime;
+            if(!function(element)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for(int y = top; y <= bottom; y ++) {
+        for(int x = left; x <= right; x ++) {
+            Chunk &chunk = chunks[y * width + x];
+            lazyClear(chunk);
+            if(!processChunk(chunk, elements) || !processChunk(staticChunks[y * width + x], staticElements)) {
+                return;
+            }
+        }
+    }
+}
 
 void TA_HitboxContainer::add(TA_Polygon &hitbox, int type)
 {
@@ -10,68 +92,117 @@ void TA_HitboxContainer::add(TA_Polygon &hitbox, int type)
     if(hitbox.empty()) {
         return;
     }
-    Element element = {&hitbox, type};
-
-    auto addToChunk = [&](Chunk &chunk) {
-        lazyClear(chunk);
-        chunk.elements.push_back(element);
-    };
+    int index = elements.size();
+    elements.push_back({&hitbox, type});
 
-    TA_Point topLeft = hitbox.getTopLeft(), bottomRight = hitbox.getBottomRight();
-    int left = topLeft.x / chunkSize, top = topLeft.y / chunkSize, right = bottomRight.x / chunkSize, bottom = bottomRight.y / chunkSize;
+    int left, top, right, bottom;
+    getChunkRange(hitbox.getBoundsTopLeft(), hitbox.getBoundsBottomRight(), left, top, right, bottom);
 
-    if(0 <= top && bottom < size && 0 <= left && right < size && right - left <= 1 && bottom - top <= 1) {
-        addToChunk(chunks[top][left]);
-        if(right != left) {
-            addToChunk(chunks[top][right]);
+    for(int y = top; y <= bottom; y ++) {
+        for(int x = left; x <= right; x ++) {
+            Chunk &chunk = chunks[y * width + x];
+            lazyClear(chunk);
+            chunk.elements.push_back(index);
+            chunk.typeMask |= type;
         }
-        if(bottom != top) {
-            addToChunk(chunks[bottom][left]);
-        }
-        if(right != left && bottom != top) {
-            addToChunk(chunks[bottom][right]);
-        }
-    }
-    else {
-        addToChunk(commonChunk);
     }
 }
 
-int TA_HitboxContainer::getCollisionFlags(TA_Polygon &hitbox)
+int TA_HitboxContainer::getCollisionFlags(TA_Polygon &hitbox, int mask)
 {
     int flags = 0;
 
-    auto processChunk = [&](Chunk &chunk) {
-        lazyClear(chunk);
-        for(Element &element : chunk.elements) {
-            if(hitbox.intersects(*element.hitbox)) {
-                flags |= element.type;
-            }
+    forEachElement(hitbox.getBoundsTopLeft(), hitbox.getBoundsBottomRight(), mask, [&](Element &element) {
+        if((flags & element.type & mask) != (element.type & mask) && hitbox.intersects(*element.hitbox)) {
+            flags |= element.type;
         }
-    };
+        return (flags & mask) != mask;
+    });
 
-    auto processChunkAt = [&](int x, int y) {
-        if(0 <= x && x < (int)chunks.size() && 0 <= y && y <= (int)chunks[x].size()) {
-            processChunk(chunks[x][y]);
-        }
-    };
+    return flags & mask;
+}
+
+void TA_HitboxContainer::addCollisionCandidates(TA_Rect bounds, int mask, std::vector<TA_CollisionHitbox> &candidates)
+{
+    forEachElement(bounds.topLeft, bounds.bottomRight, mask, [&](Element &element) {
+        candidates.push_back({*element.hitbox, element.type});
+        return true;
+    });
+}
+
+int TA_HitboxContainer::addStatic(TA_Polygon &hitbox, int type)
+{
+    if(type == TA_COLLISION_TRANSPARENT) {
+        return -1;
+    }
+    countStaticType(type, 1);
+
+    int index;
+    if(freeStaticElements.empty()) {
+        index = staticElements.size();
+        staticElements.emplace_back();
+    }
+    else {
+        index = freeStaticElements.back();
+        freeStaticElements.pop_back();
+    }
+
+    StaticElement &element = staticElements[index];
+    element = StaticElement();
+    element.hitbox = &hitbox;
+    element.type = type;
 
-    TA_Point topLeft = hitbox.getTopLeft(), bottomRight = hitbox.getBottomRight();
-    int left = topLeft.x / chunkSize, top = topLeft.y / chunkSize, right = bottomRight.x / chunkSize, bottom = bottomRight.y / chunkSize;
+    if(hitbox.empty()) {
+        return index;
+    }
 
-    processChunk(commonChunk);
-    processChunkAt(top, left);
-    if(right != left) {
-        processChunkAt(top, right);
+    getChunkRange(hitbox.getBoundsTopLeft(), hitbox.getBoundsBottomRight(), element.left, element.top, element.right, element.bottom);
+    for(int y = element.top; y <= element.bottom; y ++) {
+        for(int x = element.left; x <= element.right; x ++) {
+            Chunk &chunk = staticChunks[y * width + x];
+            chunk.elements.push_back(index);
+            chunk.typeMask |= type;
+        }
     }
-    if(bottom != top) {
-        processChunkAt(bottom, left);
+    return index;
+}
+
+void TA_HitboxContainer::removeStatic(int id)
+{
+    if(id == -1) {
+        return;
     }
-    if(right != left && bottom != top) {
-        processChunkAt(bottom, right);
+
+    StaticElement &element = staticElements[id];
+    for(int y = element.top; y <= element.bottom; y ++) {
+        for(int x = element.left; x <= element.right; x ++) {
+            Chunk &chunk = staticChunks[y * width + x];
+            chunk.elements.erase(std::find(chunk.elements.begin(), chunk.elements.end(), id));
+            chunk.typeMask = 0;
+            for(int index : chunk.elements) {
+                chunk.typeMask |= staticElements[index].type;
+            }
+        }
     }
 
-    return flags;
+    countStaticType(element.type, -1);
+    element = StaticElement();
+    freeStaticElements.push_back(id);
+}
+
+void TA_HitboxContainer::countStaticType(int type, int add)
+{
+    for(int bit = 0; bit < int(staticTypeCounts.size()); bit ++) {
+        if(type & (1 << bit)) {
+            staticTypeCounts[bit] += add;
+            if(staticTypeCounts[bit] != 0) {
+                staticCollisionTypeMask |= (1 << bit);
+            }
+            else {
+                staticCollisionTypeMask &= ~(1 << bit);
+            }
+        }
+    }
 }
 
 void TA_HitboxContainer::lazyClear(Chunk &chunk)
@@ -80,11 +211,13 @@ void TA_HitboxContainer::lazyClear(Chunk &chunk)
         return;
     }
     chunk.elements.clear();
+    chunk.typeMask = 0;
     chunk.updateTime = currentTime;
 }
 
 void TA_HitboxContainer::clear()
 {
     currentTime ++;
+    elements.clear();
     collisionTypeMask = 0;
 }
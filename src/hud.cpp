@@ -33,9 +33,17 @@ void TA_Hud::load(TA_Links newLinks)
 
     pauseMenu.load(links);
 
+    // drawn every frame, so the parameters are resolved once
+    std::string itemPrefix = (links.seaFox ? "seafox_" : "");
+    ringsParameter = TA::save::getSaveParameterHandle("rings");
+    itemPositionParameter = TA::save::getSaveParameterHandle(itemPrefix + "item_position");
+    for(int slot = 0; slot < 4; slot ++) {
+        itemSlotParameters[slot] = TA::save::getSaveParameterHandle(itemPrefix + "item_slot" + std::to_string(slot));
+    }
+
     itemPosition = TA::save::getSaveParameter("item_position");
     flightBarSprite.load("hud/flightbar.png");
-    rings = TA::save::getSaveParameter("rings");
+    rings = TA::save::getSaveParameter(ringsParameter);
 
     switchSound.load("sound/switch.ogg", TA_SOUND_CHANNEL_SFX1);
     itemSwitchSound.load("sound/item_switch.ogg", TA_SOUND_CHANNEL_SFX1);
@@ -100,8 +108,7 @@ void TA_Hud::updatePauseMenu()
         exitPause = true;
         timer = 0;
 
-        const std::string itemPositionKey = (links.seaFox == nullptr ? "item_position" : "seafox_item_position");
-        itemPosition = static_cast<int>(TA::save::getSaveParameter(itemPositionKey));
+        itemPosition = static_cast<int>(TA::save::getSaveParameter(itemPositionParameter));
     }
     if(result == TA_PauseMenu::UpdateResult::QUIT) {
         transition = TA_SCREENSTATE_MAP;
@@ -126,7 +133,7 @@ void TA_Hud::setHudAlpha(int alpha)
 
 void TA_Hud::updateRingsCounter()
 {
-    int actualRings = TA::save::getSaveParameter("rings");
+    int actualRings = TA::save::getSaveParameter(ringsParameter);
     actualRings = std::max(actualRings, 0);
     actualRings = std::min(actualRings, 99);
 
@@ -162,8 +169,7 @@ void TA_Hud::updateCurrentItem()
         itemSwitchSound.play();
     }
 
-    std::string itemPositionKey = (links.seaFox ? "seafox_item_position" : "item_position");
-    TA::save::setSaveParameter(itemPositionKey, itemPosition);
+    TA::save::setSaveParameter(itemPositionParameter, itemPosition);
 }
 
 void TA_Hud::draw()
@@ -181,8 +187,7 @@ void TA_Hud::draw()
 
 void TA_Hud::drawCurrentItem()
 {
-    std::string itemKey = (links.seaFox ? "seafox_item_slot" : "item_slot") + std::to_string(itemPosition);
-    item = TA::save::getSaveParameter(itemKey);
+    item = TA::save::getSaveParameter(itemSlotParameters[itemPosition]);
     if(item == -1) {
         item = 38;
     }
@@ -11,9 +11,16 @@ namespace TA { namespace keyboard {
     void updateMapping();
 }}
 
-void TA::keyboard::update()
+void TA::keyboard::init()
 {
+    for(std::string name : {"a", "b", "start", "lb", "rb", "rewind", "up", "down", "left", "right"}) {
+        TA::save::addListener(TA::save::getParameterHandle("keyboard_map_" + name), updateMapping);
+    }
     updateMapping();
+}
+
+void TA::keyboard::update()
+{
     std::array<bool, SDL_SCANCODE_COUNT> keyboardState = getKeyboardState();
 
     for(int button = 0; button < SDL_SCANCODE_COUNT; button ++) {
@@ -29,20 +36,29 @@ void TA::keyboard::update()
 
 void TA::keyboard::updateMapping()
 {
-    auto getMap = [] (std::string name) {
-        return (SDL_Scancode)TA::save::getParameter("keyboard_map_" + name);
+    auto getHandle = [] (std::string name) {
+        return TA::save::getParameterHandle("keyboard_map_" + name);
     };
+    auto getMap = [] (TA_ParameterHandle handle) {
+        return (SDL_Scancode)TA::save::getParameter(handle);
+    };
+
+    static const TA_ParameterHandle a = getHandle("a"), b = getHandle("b"), start = getHandle("start"),
+        lb = getHandle("lb"), rb = getHandle("rb"), rewind = getHandle("rewind");
+    static const TA_ParameterHandle up = getHandle("up"), down = getHandle("down"),
+        left = getHandle("left"), right = getHandle("right");
 
-    mapping[TA_BUTTON_A] = getMap("a");
-    mapping[TA_BUTTON_B] = getMap("b");
-    mapping[TA_BUTTON_PAUSE] = getMap("start");
-    mapping[TA_BUTTON_LB] = getMap("lb");
-    mapping[TA_BUTTON_RB] = getMap("rb");
+    mapping[TA_BUTTON_A] = getMap(a);
+    mapping[TA_BUTTON_B] = getMap(b);
+    mapping[TA_BUTTON_PAUSE] = getMap(start);
+    mapping[TA_BUTTON_LB] = getMap(lb);
+    mapping[TA_BUTTON_RB] = getMap(rb);
+    mapping[TA_BUTTON_REWIND] = getMap(rewind);
 
-    directionMapping[TA_DIRECTION_UP] = getMap("up");
-    directionMapping[TA_DIRECTION_DOWN] = getMap("down");
-    directionMapping[TA_DIRECTION_LEFT] = getMap("left");
-    directionMapping[TA_DIRECTION_RIGHT] = getMap("right");
+    directionMapping[TA_DIRECTION_UP] = getMap(up);
+    directionMapping[TA_DIRECTION_DOWN] = getMap(down);
+    directionMapping[TA_DIRECTION_LEFT] = getMap(left);
+    directionMapping[TA_DIRECTION_RIGHT] = getMap(right);
 }
 
 std::array<bool, SDL_SCANCODE_COUNT> TA::keyboard::getKeyboardState()
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include "level_file.h"
+#include "filesystem.h"
+#include "asset_pack.h"
+#include "error.h"
+#include "tilemap.h"
+#include "object_set.h"
+
+TA_LevelFile::~TA_LevelFile()
+{
+    close();
+}
+
+std::array<int64_t, 4> TA_LevelFile::getSourceStamp(const std::string &levelPath)
+{
+    std::array<int64_t, 4> stamp{};
+    int pos = 0;
+    for(std::string filename : {levelPath + ".tmx", levelPath + ".xml"}) {
+        TA::filesystem::fixPath(filename);
+        std::filesystem::path path = TA::filesystem::getAssetsPath() + "/" + filename;
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        if(!error) {
+            auto time = std::filesystem::last_write_time(path, error);
+            stamp[pos] = size;
+            stamp[pos + 1] = (error ? 0 : time.time_since_epoch().count());
+        }
+        pos += 2;
+    }
+    return stamp;
+}
+
+bool TA_LevelFile::open(const std::string &levelPath)
+{
+    close();
+    std::string filename = levelPath + ".bin";
+    TA::filesystem::fixPath(filename);
+    data = TA::assetPack::getAsset(filename);
+    bool packed = !data.empty();
+    if(!packed) {
+        if(!file.open(TA::filesystem::getAssetsPath() + "/" + filename)) {
+            return false;
+        }
+        data = file.getData();
+    }
+
+    const void *fileMagic = readBytes(sizeof(magic));
+    if(fileMagic == nullptr || std::memcmp(fileMagic, magic, sizeof(magic)) != 0) {
+        TA::printWarning("%s is not a level file", filename.c_str());
+        close();
+        return false;
+    }
+    int32_t fileVersion = readInt();
+    if(fileVersion != version) {
+        TA::printWarning("%s has version %i instead of %i, falling back to XML", filename.c_str(), fileVersion, version);
+        close();
+        return false;
+    }
+    std::array<int64_t, 4> sourceStamp{};
+    if(const void *bytes = readBytes(sizeof(sourceStamp))) {
+        std::memcpy(sourceStamp.data(), bytes, sizeof(sourceStamp));
+    }
+    if(packed) {
+        return true;
+    }
+    std::array<int64_t, 4> currentStamp = getSourceStamp(levelPath);
+    if(currentStamp != std::array<int64_t, 4>{} && currentStamp != sourceStamp) {
+        TA::printWarning("%s is older than its sources, falling back to XML", filename.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TA_LevelFile::close()
+{
+    file.close();
+    data = {};
+    offset = 0;
+    failed = false;
+}
+
+const void* TA_LevelFile::readBytes(size_t count)
+{
+    if(failed || count > data.size() - offset) {
+        failed = true;
+        return nullptr;
+    }
+    const char *bytes = data.data() + offset;
+    offset += count;
+    return bytes;
+}
+
+int32_t TA_LevelFile::readInt()
+{
+    int32_t value = 0;
+    if(const void *bytes = readBytes(sizeof(value))) {
+        std::memcpy(&value, bytes, sizeof(value));
+    }
+    return value;
+}
+
+double TA_LevelFile::readDouble()
+{
+    double value = 0;
+    if(const void *bytes = readBytes(sizeof(value))) {
+        std::memcpy(&value, bytes, sizeof(value));
+    }
+    return value;
+}
+
+std::string TA_LevelFile::readString()
+{
+    int32_t length = readInt();
+    if(length < 0) {
+        failed = true;
+        return "";
+    }
+    const char *bytes = static_cast<const char*>(readBytes(length));
+    return (bytes != nullptr ? std::string(bytes, length) : "");
+}
+
+TA_LevelFileWriter::TA_LevelFileWriter(const std::string &levelPath)
+{
+    writeBytes(TA_LevelFile::magic, sizeof(TA_LevelFile::magic));
+    writeInt(TA_LevelFile::version);
+    std::array<int64_t, 4> sourceStamp = TA_LevelFile::getSourceStamp(levelPath);
+    writeBytes(sourceStamp.data(), sizeof(sourceStamp));
+}
+
+void TA_LevelFileWriter::writeInt(int32_t value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void TA_LevelFileWriter::writeDouble(double value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void TA_LevelFileWriter::writeString(const std::string &value)
+{
+    writeInt(value.size());
+    writeBytes(value.data(), value.size());
+}
+
+void TA_LevelFileWriter::writeBytes(const void *bytes, size_t count)
+{
+    data.append(static_cast<const char*>(bytes), count);
+}
+
+void TA_LevelFileWriter::save(std::string filename)
+{
+    TA::filesystem::writeFile(filename, data);
+}
+
+void TA::levelFile::bakeLevels()
+{
+    using Clock = std::chrono::steady_clock;
+    auto getMilliseconds = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    std::filesystem::path mapsPath = TA::filesystem::getAssetsPath() + "/maps";
+    std::vector<std::string> levels;
+    for(const std::filesystem::directory_entry &entry : std::filesystem::recursive_directory_iterator(mapsPath)) {
+        std::filesystem::path path = entry.path();
+        if(path.extension() == ".tmx" && std::filesystem::exists(std::filesystem::path(path).replace_extension(".xml"))) {
+            levels.push_back("maps/" + std::filesystem::relative(path, mapsPath).replace_extension().generic_string());
+        }
+    }
+    std::sort(levels.begin(), levels.end());
+
+    for(const std::string &level : levels) {
+        int chunkSize;
+        std::vector<TA_ObjectSpawn> spawns;
+
+        // this also fills texture and asset caches, so the timings below only measure parsing
+        TA_LevelFileWriter writer(level);
+        {
+            TA_Tilemap tilemap;
+            tilemap.load(level + ".tmx");
+            tilemap.bake(writer);
+        }
+        TA_ObjectSet::parseObjects(level + ".xml", chunkSize, spawns);
+        TA_ObjectSet::writeObjects(writer, chunkSize, spawns);
+        writer.save(TA::filesystem::getAssetsPath() + "/" + level + ".bin");
+
+        Clock::time_point start = Clock::now();
+        {
+            TA_Tilemap tilemap;
+            tilemap.load(level + ".tmx");
+            TA_ObjectSet::parseObjects(level + ".xml", chunkSize, spawns);
+        }
+        double xmlTime = getMilliseconds(start);
+
+        start = Clock::now();
+        {
+            TA_LevelFile file;
+            if(!file.open(level)) {
+                TA::handleError("Failed to open baked %s", level.c_str());
+            }
+            TA_Tilemap tilemap;
+            tilemap.load(file);
+            TA_ObjectSet::readObjects(file, chunkSize, spawns);
+            if(file.isFailed()) {
+                TA::handleError("Failed to read baked %s", level.c_str());
+            }
+        }
+        double bakedTime = getMilliseconds(start);
+
+        std::printf("%s: xml %.3f ms, baked %.3f ms\n", level.c_str(), xmlTime, bakedTime);
+    }
+}
@@ -6,6 +6,9 @@ int main(int argc, char* argv[])
 {
     for(int pos = 1; pos < argc; pos ++) {
         TA::arguments.insert(argv[pos]);
+        if(pos + 1 < argc) {
+            TA::argumentValues[argv[pos]] = argv[pos + 1];
+        }
     }
 
     TA_Game game;
@@ -0,0 +1,31 @@
+#include "object_pool.h"
+
+void* TA_ObjectPool::allocate(size_t size)
+{
+    size = getSizeClass(size);
+
+    std::vector<void*> &freeList = freeLists[size];
+    if(!freeList.empty()) {
+        void *memory = freeList.back();
+        freeList.pop_back();
+        return memory;
+    }
+
+    if(size > blockSize) {
+        largeBlocks.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+        return largeBlocks.back().get();
+    }
+    if(blockOffset + size > blockSize) {
+        blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(blockSize));
+        blockOffset = 0;
+    }
+
+    void *memory = blocks.back().get() + blockOffset;
+    blockOffset += size;
+    return memory;
+}
+
+void TA_ObjectPool::release(void *memory, size_t size)
+{
+    freeLists[getSizeClass(size)].push_back(memory);
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <typeindex>
 #include "object_set.h"
 #include "objects/explosion.h"
 #include "objects/bomb.h"
@@ -36,6 +38,10 @@
 #include "objects/mini_sub.h"
 #include "objects/enemy_mine.h"
 #include "objects/conveyor_belt.h"
+#include "objects/bullet.h"
+#include "objects/mecha_golem_bomb.h"
+#include "objects/napalm_fire.h"
+#include "objects/splash.h"
 
 TA_Object::TA_Object(TA_ObjectSet *newObjectSet)
 {
@@ -52,6 +58,17 @@ void TA_Object::updatePosition()
     }
 }
 
+bool TA_Object::checkPawnCollision(TA_Polygon &hitbox)
+{
+    int mask = getSolidCollisionMask();
+    return mask != 0 && objectSet->checkCollisionTypes(hitbox, mask) != 0;
+}
+
+void TA_Object::addCollisionCandidates(TA_Rect bounds, std::vector<TA_CollisionHitbox> &candidates)
+{
+    objectSet->addCollisionCandidates(bounds, getSolidCollisionMask(), candidates);
+}
+
 TA_Point TA_Object::getDistanceToCharacter()
 {
     TA_Point characterPosition = objectSet->getCharacterPosition();
@@ -59,13 +76,71 @@ TA_Point TA_Object::getDistanceToCharacter()
     return characterPosition - centeredPosition;
 }
 
-void TA_ObjectSet::load(std::string filename)
+void TA_Object::serialize(TA_StateBuffer &buffer)
 {
-    tinyxml2::XMLDocument file;
-    file.Parse(TA::resmgr::loadAsset(filename).c_str());
+    TA_Pawn::serialize(buffer);
+    buffer.sync(hitbox);
+    buffer.sync(hitboxVector);
+}
 
-    for(tinyxml2::XMLElement *element = file.FirstChildElement("objects")->FirstChildElement("object");
-        element != nullptr; element = element->NextSiblingElement("object"))
+namespace {
+    // indices match TA_ObjectType
+    const char* const objectNames[] = {
+        "breakable_block", "walker", "hover_pod", "pushable_rock", "pushable_spring", "spawn_point",
+        "level_transition", "map_transition", "bridge", "camera_lock_point", "bird_walker", "bat_robot",
+        "sound", "nezu", "flame", "fire", "item_box", "drill_mole", "moving_platform", "bomb_thrower",
+        "rock_thrower", "jumper", "wind", "strong_wind", "speedy", "mecha_golem", "grass_block",
+        "mini_sub", "mine", "conveyor_belt", "ring"
+    };
+
+    // textures the object classes load by themselves, indices match TA_ObjectType; prefetched with the level
+    const std::vector<std::string> objectTextures[] = {
+        {}, // breakable_block, spawn paths
+        {"objects/pf_enemies.png", "objects/walker_bullet.png"},
+        {"objects/pf_enemies.png"},
+        {"objects/rock.png"},
+        {"objects/spring.png", "objects/spring_bounce.png"},
+        {}, {}, {}, {}, {}, // spawn_point, level_transition, map_transition, bridge, camera_lock_point
+        {"objects/bird_walker/head.png", "objects/bird_walker/body.png", "objects/bird_walker/feet.png"},
+        {"objects/bat_robot.png"},
+        {}, // sound
+        {"objects/nezu.png", "objects/nezu_bomb.png"},
+        {"objects/flame.png"},
+        {"objects/fire.png"},
+        {"hud/items.png", "fonts/item.png"},
+        {"objects/drill_mole.png"},
+        {"maps/pm/platform.png"},
+        {"objects/bomb_thrower.png", "objects/enemy_bomb.png"},
+        {"objects/rock_thrower.png", "objects/enemy_rock.png"},
+        {"objects/jumper.png"},
+        {"objects/leaf.png"},
+        {"objects/leaf.png"},
+        {"objects/speedy.png", "tails/tails.png"},
+        {"objects/mecha_golem/head.png", "objects/mecha_golem/body.png", "objects/mecha_golem/feet.png",
+            "objects/mecha_golem/arm.png", "objects/mecha_golem/arm_part.png", "objects/mecha_golem/bomb.png"},
+        {}, // grass_block, spawn path
+        {"objects/mini_sub.png"},
+        {"objects/mine.png"},
+        {}, // conveyor_belt
+        {"objects/ring.png"}
+    };
+    static_assert(std::size(objectTextures) == std::size(objectNames));
+
+    void prefetchSpawnTextures(const TA_ObjectSpawn &spawn)
+    {
+        for(const std::string &path : {spawn.path, spawn.secondPath}) {
+            if(path.ends_with(".png")) {
+                TA::resmgr::prefetchTexture(path);
+            }
+        }
+        if(spawn.type >= 0 && spawn.type < int(std::size(objectTextures))) {
+            for(const std::string &texture : objectTextures[spawn.type]) {
+                TA::resmgr::prefetchTexture(texture);
+            }
+        }
+    }
+
+    TA_ObjectSpawn parseObject(tinyxml2::XMLElement *element)
     {
         std::string name = element->Attribute("name");
         if(element->IntAttribute("tile_x")) {
@@ -75,239 +150,391 @@ void TA_ObjectSet::load(std::string filename)
             element->SetAttribute("y", element->IntAttribute("tile_y") * 16);
         }
 
-        if(name == "breakable_block") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            bool dropsRing = false;
-            if(element->Attribute("drops_ring", "true")) {
-                dropsRing = true;
-            }
-            std::string path = "maps/pf/pf_block.png", particlePath = "maps/pf/pf_rock.png";
-            if(element->Attribute("path")) {
-                path = element->Attribute("path");
-            }
-            if(element->Attribute("particle_path")) {
-                particlePath = element->Attribute("particle_path");
-            }
-            spawnObject<TA_BreakableBlock>(path, particlePath, position, dropsRing);
+        TA_ObjectSpawn spawn;
+        auto found = std::find(std::begin(objectNames), std::end(objectNames), name);
+        if(found == std::end(objectNames)) {
+            TA::handleError("Unknown object %s", name.c_str());
         }
+        spawn.type = found - std::begin(objectNames);
+
+        auto getString = [&](const char *attribute, std::string defaultValue = "") {
+            return std::string(element->Attribute(attribute) ? element->Attribute(attribute) : defaultValue);
+        };
+
+        auto readArea = [&]() {
+            spawn.position = TA_Point(element->IntAttribute("left"), element->IntAttribute("top"));
+            spawn.end = TA_Point(element->IntAttribute("right"), element->IntAttribute("bottom"));
+        };
+
+        spawn.position = TA_Point(element->IntAttribute("x"), element->IntAttribute("y"));
+
+        switch(spawn.type) {
+            case TA_OBJECT_BREAKABLE_BLOCK:
+                spawn.flag = element->Attribute("drops_ring", "true");
+                spawn.path = getString("path", "maps/pf/pf_block.png");
+                spawn.secondPath = getString("particle_path", "maps/pf/pf_rock.png");
+                break;
+
+            case TA_OBJECT_WALKER:
+            case TA_OBJECT_HOVER_POD:
+                spawn.value = element->IntAttribute("range");
+                spawn.flag = !element->Attribute("direction", "right");
+                break;
+
+            case TA_OBJECT_SPAWN_POINT:
+                spawn.path = getString("previous");
+                spawn.flag = element->Attribute("direction", "left");
+                break;
+
+            case TA_OBJECT_LEVEL_TRANSITION:
+                readArea();
+                spawn.path = element->Attribute("path");
+                break;
+
+            case TA_OBJECT_MAP_TRANSITION:
+                readArea();
+                spawn.value = element->IntAttribute("selection");
+                spawn.flag = element->Attribute("seafox", "true");
+                break;
+
+            case TA_OBJECT_WIND:
+                readArea();
+                spawn.velocity = TA_Point(element->DoubleAttribute("xsp"), element->DoubleAttribute("ysp"));
+                break;
+
+            case TA_OBJECT_STRONG_WIND:
+                readArea();
+                break;
+
+            case TA_OBJECT_CONVEYOR_BELT:
+                readArea();
+                spawn.flag = element->Attribute("direction", "right");
+                break;
+
+            case TA_OBJECT_BRIDGE:
+                spawn.position = TA_Point(element->IntAttribute("leftx"), element->IntAttribute("y"));
+                spawn.end = TA_Point(element->IntAttribute("rightx"), element->IntAttribute("y"));
+                spawn.path = element->Attribute("path");
+                spawn.secondPath = element->Attribute("particle_path");
+                break;
+
+            case TA_OBJECT_BIRD_WALKER:
+                spawn.value = element->IntAttribute("floor_y");
+                break;
+
+            case TA_OBJECT_SOUND:
+            case TA_OBJECT_GRASS_BLOCK:
+                spawn.path = element->Attribute("path");
+                break;
+
+            case TA_OBJECT_FLAME:
+                spawn.flag = element->Attribute("speed");
+                spawn.value = element->DoubleAttribute("speed");
+                break;
+
+            case TA_OBJECT_FIRE:
+            case TA_OBJECT_ROCK_THROWER:
+                spawn.flag = element->Attribute("direction", "right");
+                break;
+
+            case TA_OBJECT_ITEM_BOX:
+                spawn.value = element->IntAttribute("number");
+                spawn.path = element->Attribute("item_name");
+                break;
+
+            case TA_OBJECT_MOVING_PLATFORM:
+                spawn.position = TA_Point(element->IntAttribute("start_x"), element->IntAttribute("start_y"));
+                spawn.end = TA_Point(element->IntAttribute("end_x"), element->IntAttribute("end_y"));
+                spawn.flag = !element->Attribute("idle", "false");
+                break;
+
+            case TA_OBJECT_BOMB_THROWER:
+                spawn.value = element->IntAttribute("left_x");
+                spawn.secondValue = element->IntAttribute("right_x");
+                break;
+
+            default:
+                break;
+        }
+        return spawn;
+    }
+}
 
-        else if(name == "walker" || name == "hover_pod") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            int range = 0;
-            bool direction = true;
-            if (element->Attribute("range")) {
-                range = element->IntAttribute("range");
-            }
-            if (element->Attribute("direction", "right")) {
-                direction = false;
-            }
-            if(name == "walker") {
-                spawnObject<TA_Walker>(position, range, direction);
-            }
-            else {
-                spawnObject<TA_HoverPod>(position, range, direction);
+void TA_ObjectSet::parseObjects(std::string filename, int &chunkSize, std::vector<TA_ObjectSpawn> &spawns)
+{
+    tinyxml2::XMLDocument file;
+    std::string_view xmlData = TA::resmgr::loadAsset(filename);
+    file.Parse(xmlData.data(), xmlData.size());
+
+    tinyxml2::XMLElement *root = file.FirstChildElement("objects");
+    chunkSize = root->IntAttribute("chunk_size", 0);
+    spawns.clear();
+    for(tinyxml2::XMLElement *element = root->FirstChildElement("object");
+        element != nullptr; element = element->NextSiblingElement("object"))
+    {
+        spawns.push_back(parseObject(element));
+    }
+}
+
+void TA_ObjectSet::writeObjects(TA_LevelFileWriter &writer, int chunkSize, const std::vector<TA_ObjectSpawn> &spawns)
+{
+    writer.writeInt(chunkSize);
+    writer.writeInt(spawns.size());
+    for(const TA_ObjectSpawn &spawn : spawns) {
+        writer.writeInt(spawn.type);
+        for(double value : {spawn.position.x, spawn.position.y, spawn.end.x, spawn.end.y,
+            spawn.velocity.x, spawn.velocity.y, spawn.value, spawn.secondValue}) {
+            writer.writeDouble(value);
+        }
+        writer.writeInt(spawn.flag);
+        writer.writeString(spawn.path);
+        writer.writeString(spawn.secondPath);
+    }
+}
+
+void TA_ObjectSet::readObjects(TA_LevelFile &file, int &chunkSize, std::vector<TA_ObjectSpawn> &spawns)
+{
+    chunkSize = file.readInt();
+    int count = file.readInt();
+    spawns.clear();
+    for(int pos = 0; pos < count && !file.isFailed(); pos ++) {
+        TA_ObjectSpawn spawn;
+        spawn.type = file.readInt();
+        for(double *value : {&spawn.position.x, &spawn.position.y, &spawn.end.x, &spawn.end.y,
+            &spawn.velocity.x, &spawn.velocity.y, &spawn.value, &spawn.secondValue}) {
+            *value = file.readDouble();
+        }
+        spawn.flag = file.readInt();
+        spawn.path = file.readString();
+        spawn.secondPath = file.readString();
+        spawns.push_back(spawn);
+    }
+}
+
+void TA_ObjectSet::prefetchLevel(std::string levelPath)
+{
+    TA::resmgr::runInBackground([levelPath]() {
+        TA_LevelFile levelFile;
+        if(levelFile.open(levelPath)) {
+            TA_Tilemap::prefetch(levelFile);
+            int chunkSize;
+            std::vector<TA_ObjectSpawn> spawns;
+            readObjects(levelFile, chunkSize, spawns);
+            if(!levelFile.isFailed()) {
+                for(const TA_ObjectSpawn &spawn : spawns) {
+                    prefetchSpawnTextures(spawn);
+                }
             }
+            return;
         }
 
-        else if(name == "pushable_rock" || name == "pushable_spring") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            if(name == "pushable_rock") {
-                spawnObject<TA_PushableRock>(position);
+        TA_Tilemap::prefetch(levelPath + ".tmx");
+        TA::resmgr::prefetchAsset(levelPath + ".xml", [](std::string_view xmlData) {
+            tinyxml2::XMLDocument file;
+            file.Parse(xmlData.data(), xmlData.size());
+            tinyxml2::XMLElement *root = file.FirstChildElement("objects");
+            if(root == nullptr) {
+                return;
             }
-            else {
-                spawnObject<TA_PushableSpring>(position);
+            for(tinyxml2::XMLElement *element = root->FirstChildElement("object");
+                element != nullptr; element = element->NextSiblingElement("object"))
+            {
+                prefetchSpawnTextures(parseObject(element));
             }
+        });
+    });
+}
+
+void TA_ObjectSet::load(std::string filename)
+{
+    int chunkSize;
+    std::vector<TA_ObjectSpawn> spawns;
+    parseObjects(filename, chunkSize, spawns);
+    load(chunkSize, spawns);
+}
+
+void TA_ObjectSet::load(TA_LevelFile &file)
+{
+    int chunkSize;
+    std::vector<TA_ObjectSpawn> spawns;
+    readObjects(file, chunkSize, spawns);
+    if(file.isFailed()) {
+        TA::handleError("%s", "Level file is truncated");
+    }
+    load(chunkSize, spawns);
+}
+
+void TA_ObjectSet::load(int chunkSize, const std::vector<TA_ObjectSpawn> &spawns)
+{
+    if(links.tilemap) {
+        if(chunkSize != 0) {
+            hitboxContainer.setSize(links.tilemap->getWidth(), links.tilemap->getHeight(), chunkSize);
         }
+        else {
+            hitboxContainer.setSize(links.tilemap->getWidth(), links.tilemap->getHeight());
+        }
+    }
 
-        else if(name == "spawn_point") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            std::string currentLevelPath = "";
-            if(element->Attribute("previous")) {
-                currentLevelPath = element->Attribute("previous");
-            }
-            if(!firstSpawnPointSet || currentLevelPath == TA::previousLevelPath) {
+    for(const TA_ObjectSpawn &spawn : spawns) {
+        loadObject(spawn);
+    }
+}
+
+void TA_ObjectSet::loadObject(const TA_ObjectSpawn &spawn)
+{
+    const TA_Point &position = spawn.position;
+
+    switch(spawn.type) {
+        case TA_OBJECT_BREAKABLE_BLOCK:
+            spawnObject<TA_BreakableBlock>(spawn.path, spawn.secondPath, position, spawn.flag);
+            break;
+
+        case TA_OBJECT_WALKER:
+            spawnObject<TA_Walker>(position, int(spawn.value), spawn.flag);
+            break;
+
+        case TA_OBJECT_HOVER_POD:
+            spawnObject<TA_HoverPod>(position, int(spawn.value), spawn.flag);
+            break;
+
+        case TA_OBJECT_PUSHABLE_ROCK:
+            spawnObject<TA_PushableRock>(position);
+            break;
+
+        case TA_OBJECT_PUSHABLE_SPRING:
+            spawnObject<TA_PushableSpring>(position);
+            break;
+
+        case TA_OBJECT_SPAWN_POINT:
+            if(!firstSpawnPointSet || spawn.path == TA::previousLevelPath) {
                 spawnPoint = position;
-                if(element->Attribute("direction")) {
-                    spawnFlip = element->Attribute("direction", "left");
-                }
-                else {
-                    spawnFlip = false;
-                }
+                spawnFlip = spawn.flag;
                 firstSpawnPointSet = true;
             }
-        }
+            break;
 
-        else if(name == "level_transition") {
-            TA_Point topLeft(element->IntAttribute("left"), element->IntAttribute("top"));
-            TA_Point bottomRight(element->IntAttribute("right"), element->IntAttribute("bottom"));
-            std::string levelPath = element->Attribute("path");
-            spawnObject<TA_Transition>(topLeft, bottomRight, levelPath);
-        }
+        case TA_OBJECT_LEVEL_TRANSITION:
+            spawnObject<TA_Transition>(position, spawn.end, spawn.path);
+            prefetchLevel(spawn.path);
+            break;
 
-        else if(name == "map_transition") {
-            TA_Point topLeft(element->IntAttribute("left"), element->IntAttribute("top"));
-            TA_Point bottomRight(element->IntAttribute("right"), element->IntAttribute("bottom"));
-            int selection = element->IntAttribute("selection");
-            bool seaFox = element->Attribute("seafox", "true");
-            spawnObject<TA_Transition>(topLeft, bottomRight, selection, seaFox);
-        }
+        case TA_OBJECT_MAP_TRANSITION:
+            TA_Tilemap::prefetch("worldmap/map.tmx");
+            spawnObject<TA_Transition>(position, spawn.end, int(spawn.value), spawn.flag);
+            break;
 
-        else if(name == "bridge") {
-            std::string path = element->Attribute("path");
-            std::string particlePath = element->Attribute("particle_path");
-            int left = element->IntAttribute("leftx");
-            int right = element->IntAttribute("rightx");
-            int y = element->IntAttribute("y");
-            for(int x = left; x <= right; x += 16) {
-                spawnObject<TA_Bridge>(TA_Point(x, y), path, particlePath);
+        case TA_OBJECT_BRIDGE:
+            for(int x = position.x; x <= spawn.end.x; x += 16) {
+                spawnObject<TA_Bridge>(TA_Point(x, position.y), spawn.path, spawn.secondPath);
             }
-        }
+            break;
 
-        else if(name == "camera_lock_point") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
+        case TA_OBJECT_CAMERA_LOCK_POINT:
             links.camera->setLockPosition(position);
-        }
+            break;
 
-        else if(name == "bird_walker") {
-            double floorY = element->IntAttribute("floor_y");
-            spawnObject<TA_BirdWalker>(floorY);
-        }
+        case TA_OBJECT_BIRD_WALKER:
+            spawnObject<TA_BirdWalker>(spawn.value);
+            break;
 
-        else if(name == "bat_robot") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
+        case TA_OBJECT_BAT_ROBOT:
             spawnObject<TA_BatRobot>(position);
-        }
+            break;
 
-        else if(name == "sound") {
-            TA::sound::playMusic(element->Attribute("path"));
-        }
+        case TA_OBJECT_SOUND:
+            TA::sound::playMusic(spawn.path);
+            break;
 
-        else if(name == "nezu") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
+        case TA_OBJECT_NEZU:
             spawnObject<TA_Nezu>(position);
-        }
+            break;
 
-        else if(name == "flame") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            if(element->Attribute("speed")) {
-                double speed = element->DoubleAttribute("speed");
-                spawnObject<TA_FlameLauncher>(position, speed);
+        case TA_OBJECT_FLAME:
+            if(spawn.flag) {
+                spawnObject<TA_FlameLauncher>(position, spawn.value);
             }
             else {
                 spawnObject<TA_FlameLauncher>(position);
             }
-        }
+            break;
 
-        else if(name == "fire") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            bool direction = false;
-            if(element->Attribute("direction", "right")) {
-                direction = true;
-            }
-            spawnObject<TA_Fire>(position, direction);
-        }
+        case TA_OBJECT_FIRE:
+            spawnObject<TA_Fire>(position, spawn.flag);
+            break;
 
-        else if(name == "item_box") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            int number = element->IntAttribute("number");
-            std::string itemName = element->Attribute("item_name");
-            spawnObject<TA_ItemBox>(position, TA_Point(0, 0), number, itemName);
-        }
+        case TA_OBJECT_ITEM_BOX:
+            spawnObject<TA_ItemBox>(position, TA_Point(0, 0), int(spawn.value), spawn.path);
+            break;
 
-        else if(name == "drill_mole") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
+        case TA_OBJECT_DRILL_MOLE:
             spawnObject<TA_DrillMole>(position);
-        }
+            break;
 
-        else if(name == "moving_platform") {
-            TA_Point startPosition(element->IntAttribute("start_x"), element->IntAttribute("start_y"));
-            TA_Point endPosition(element->IntAttribute("end_x"), element->IntAttribute("end_y"));
-            if(element->Attribute("idle", "false")) {
-                spawnObject<TA_MovingPlatform>(startPosition, endPosition, false);
-            }
-            else {
-                spawnObject<TA_MovingPlatform>(startPosition, endPosition, true);
-            }
-        }
+        case TA_OBJECT_MOVING_PLATFORM:
+            spawnObject<TA_MovingPlatform>(position, spawn.end, spawn.flag);
+            break;
 
-        else if(name == "bomb_thrower") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            double leftX = element->IntAttribute("left_x"), rightX = element->IntAttribute("right_x");
-            spawnObject<TA_BombThrower>(position, leftX, rightX);
-        }
+        case TA_OBJECT_BOMB_THROWER:
+            spawnObject<TA_BombThrower>(position, spawn.value, spawn.secondValue);
+            break;
 
-        else if(name == "rock_thrower") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            bool direction = element->Attribute("direction", "right");
-            spawnObject<TA_RockThrower>(position, direction);
-        }
+        case TA_OBJECT_ROCK_THROWER:
+            spawnObject<TA_RockThrower>(position, spawn.flag);
+            break;
 
-        else if(name == "jumper") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
+        case TA_OBJECT_JUMPER:
             spawnObject<TA_Jumper>(position);
-        }
+            break;
 
-        else if(name == "wind") {
-            TA_Point topLeft(element->IntAttribute("left"), element->IntAttribute("top"));
-            TA_Point bottomRight(element->IntAttribute("right"), element->IntAttribute("bottom"));
-            TA_Point velocity(element->DoubleAttribute("xsp"), element->DoubleAttribute("ysp"));
-            spawnObject<TA_Wind>(topLeft, bottomRight, velocity);
-        }
-        
-        else if(name == "strong_wind") {
-            TA_Point topLeft(element->IntAttribute("left"), element->IntAttribute("top"));
-            TA_Point bottomRight(element->IntAttribute("right"), element->IntAttribute("bottom"));
-            spawnObject<TA_StrongWind>(topLeft, bottomRight);
-        }
+        case TA_OBJECT_WIND:
+            spawnObject<TA_Wind>(position, spawn.end, spawn.velocity);
+            break;
 
-        else if(name == "speedy") {
+        case TA_OBJECT_STRONG_WIND:
+            spawnObject<TA_StrongWind>(position, spawn.end);
+            break;
+
+        case TA_OBJECT_SPEEDY:
             spawnObject<TA_Speedy>();
-        }
+            break;
 
-        else if(name == "mecha_golem") {
+        case TA_OBJECT_MECHA_GOLEM:
             spawnObject<TA_MechaGolem>();
-        }
+            break;
 
-        else if(name == "grass_block") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            std::string path = element->Attribute("path");
-            spawnObject<TA_GrassBlock>(position, path);
-        }
+        case TA_OBJECT_GRASS_BLOCK:
+            spawnObject<TA_GrassBlock>(position, spawn.path);
+            break;
 
-        else if(name == "mini_sub") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
+        case TA_OBJECT_MINI_SUB:
             spawnObject<TA_MiniSub>(position);
-        }
+            break;
 
-        else if(name == "mine") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
+        case TA_OBJECT_MINE:
             spawnObject<TA_EnemyMine>(position);
-        }
+            break;
 
-        else if(name == "conveyor_belt") {
-            TA_Point topLeft(element->IntAttribute("left"), element->IntAttribute("top"));
-            TA_Point bottomRight(element->IntAttribute("right"), element->IntAttribute("bottom"));
-            bool direction = element->Attribute("direction", "right");
-            spawnObject<TA_ConveyorBelt>(topLeft, bottomRight, direction);
-        }
+        case TA_OBJECT_CONVEYOR_BELT:
+            spawnObject<TA_ConveyorBelt>(position, spawn.end, spawn.flag);
+            break;
 
-        else if(name == "ring") {
-            TA_Point position(element->IntAttribute("x"), element->IntAttribute("y"));
-            auto* ring = new TA_Ring(this);
+        case TA_OBJECT_RING: {
+            auto* ring = createObject<TA_Ring>();
             ring->loadStationary(position);
             spawnedObjects.push_back(ring);
+            break;
         }
 
-        else {
-            TA::handleError("Unknown object %s", name.c_str());
-        }
+        default:
+            TA::handleError("Unknown object type %i", spawn.type);
     }
 }
 
 void TA_ObjectSet::update()
 {
     for(TA_Object *currentObject : deleteList) {
-        delete currentObject;
+        removeStaticHitboxes(currentObject);
+        deleteObject(currentObject);
     }
     for(TA_Object *currentObject : spawnedObjects) {
         objects.push_back(currentObject);
@@ -317,6 +544,10 @@ void TA_ObjectSet::update()
 
     hitboxContainer.clear();
     for(TA_Object *currentObject : objects) {
+        if(currentObject->isStatic()) {
+            updateStaticHitboxes(currentObject);
+            continue;
+        }
         hitboxContainer.add(currentObject->hitbox, currentObject->getCollisionType());
         for(TA_Object::HitboxVectorElement &element : currentObject->hitboxVector) {
             hitboxContainer.add(element.hitbox, element.collisionType);
@@ -335,6 +566,36 @@ void TA_ObjectSet::update()
     objects = newObjects;
 }
 
+void TA_ObjectSet::updateStaticHitboxes(TA_Object *object)
+{
+    std::vector<int> &ids = object->staticHitboxIds;
+    bool changed = (ids.size() != object->hitboxVector.size() + 1);
+
+    if(!changed) {
+        changed = (hitboxContainer.getStaticType(ids[0]) != object->getCollisionType());
+        for(size_t pos = 0; pos < object->hitboxVector.size() && !changed; pos ++) {
+            changed = (hitboxContainer.getStaticType(ids[pos + 1]) != object->hitboxVector[pos].collisionType);
+        }
+    }
+    if(!changed) {
+        return;
+    }
+
+    removeStaticHitboxes(object);
+    ids.push_back(hitboxContainer.addStatic(object->hitbox, object->getCollisionType()));
+    for(TA_Object::HitboxVectorElement &element : object->hitboxVector) {
+        ids.push_back(hitboxContainer.addStatic(element.hitbox, element.collisionType));
+    }
+}
+
+void TA_ObjectSet::removeStaticHitboxes(TA_Object *object)
+{
+    for(int id : object->staticHitboxIds) {
+        hitboxContainer.removeStatic(id);
+    }
+    object->staticHitboxIds.clear();
+}
+
 void TA_ObjectSet::draw(int priority)
 {
     for(TA_Object *currentObject : objects) {
@@ -351,8 +612,7 @@ void TA_ObjectSet::checkCollision(TA_Polygon &hitbox, int &flags)
         return;
     }
 
-    flags = links.tilemap->checkCollision(hitbox);
-    flags |= hitboxContainer.getCollisionFlags(hitbox);
+    flags = getWorldCollisionFlags(hitbox, -1);
 
     if(links.character && links.character->getHitbox()->intersects(hitbox)) {
         flags |= TA_COLLISION_CHARACTER;
@@ -377,6 +637,107 @@ int TA_ObjectSet::checkCollision(TA_Polygon &hitbox)
     return flags;
 }
 
+int TA_ObjectSet::checkCollisionTypes(TA_Polygon &hitbox, int mask)
+{
+    if(hitbox.empty()) {
+        return 0;
+    }
+
+    int flags = getWorldCollisionFlags(hitbox, mask);
+
+    if(mask & TA_COLLISION_CHARACTER) {
+        if(links.character && links.character->getHitbox()->intersects(hitbox)) {
+            flags |= TA_COLLISION_CHARACTER;
+        }
+        else if(links.seaFox && links.seaFox->getHitbox()->intersects(hitbox)) {
+            flags |= TA_COLLISION_CHARACTER;
+        }
+    }
+
+    if((mask & TA_COLLISION_ATTACK) && links.character && links.character->isUsingHammer() &&
+        links.character->getHammerHitbox()->intersects(hitbox)) {
+        flags |= TA_COLLISION_ATTACK;
+    }
+
+    if((mask & TA_COLLISION_DRILL) && links.seaFox && links.seaFox->getDrillHitbox()->intersects(hitbox)) {
+        flags |= TA_COLLISION_DRILL;
+    }
+
+    return flags & mask;
+}
+
+int TA_ObjectSet::getWorldCollisionFlags(TA_Polygon &hitbox, int mask)
+{
+    int flags = 0;
+
+    if(isInCollisionContext(hitbox.getBoundsTopLeft(), hitbox.getBoundsBottomRight())) {
+        avoidedQueries ++;
+        for(TA_CollisionHitbox &candidate : collisionContext.candidates) {
+            if((candidate.type & mask & ~flags) != 0 && hitbox.intersects(candidate.polygon)) {
+                flags |= candidate.type;
+            }
+        }
+        return flags & mask;
+    }
+
+    flags = links.tilemap->checkCollision(hitbox, mask);
+    if((flags & mask) == mask) {
+        return flags;
+    }
+    flags |= hitboxContainer.getCollisionFlags(hitbox, mask & ~flags);
+    return flags;
+}
+
+bool TA_ObjectSet::isInCollisionContext(TA_Point topLeft, TA_Point bottomRight)
+{
+    if(!collisionContext.active) {
+        return false;
+    }
+    const TA_Rect &bounds = collisionContext.bounds;
+    return bounds.topLeft.x <= topLeft.x && bounds.topLeft.y <= topLeft.y &&
+           bottomRight.x <= bounds.bottomRight.x && bottomRight.y <= bounds.bottomRight.y;
+}
+
+void TA_ObjectSet::beginCollisionContext(TA_Rect bounds)
+{
+    collisionContext.candidates.clear();
+    collisionContext.bounds = bounds;
+    links.tilemap->addCollisionCandidates(bounds, -1, collisionContext.candidates);
+    hitboxContainer.addCollisionCandidates(bounds, -1, collisionContext.candidates);
+    collisionContext.active = true;
+}
+
+void TA_ObjectSet::addCollisionCandidates(TA_Rect bounds, int mask, std::vector<TA_CollisionHitbox> &candidates)
+{
+    if(isInCollisionContext(bounds.topLeft, bounds.bottomRight)) {
+        avoidedQueries ++;
+        for(TA_CollisionHitbox &candidate : collisionContext.candidates) {
+            if(candidate.type & mask) {
+                candidates.push_back(candidate);
+            }
+        }
+    }
+    else {
+        links.tilemap->addCollisionCandidates(bounds, mask, candidates);
+        hitboxContainer.addCollisionCandidates(bounds, mask, candidates);
+    }
+
+    if(mask & TA_COLLISION_CHARACTER) {
+        if(links.character) {
+            candidates.push_back({*links.character->getHitbox(), TA_COLLISION_CHARACTER});
+        }
+        if(links.seaFox) {
+            candidates.push_back({*links.seaFox->getHitbox(), TA_COLLISION_CHARACTER});
+        }
+    }
+    if((mask & TA_COLLISION_ATTACK) && links.character && links.character->isUsingHammer()) {
+        candidates.push_back({*links.character->getHammerHitbox(), TA_COLLISION_ATTACK});
+    }
+    if((mask & TA_COLLISION_DRILL) && links.seaFox) {
+        candidates.push_back({*links.seaFox->getDrillHitbox(), TA_COLLISION_DRILL});
+    }
+}
+
 TA_Point TA_ObjectSet::getCharacterPosition()
 {
     if(links.character) {
@@ -418,9 +779,130 @@ bool TA_ObjectSet::isVisible(TA_Polygon &hitbox)
     return cameraRect.intersects(hitbox);
 }
 
+void TA_ObjectSet::serialize(TA_Snapshot &snapshot)
+{
+    if(snapshot.buffer.isReading()) {
+        loadObjects(snapshot);
+    }
+    else {
+        saveObjects(snapshot);
+    }
+    snapshot.buffer.sync(spawnPoint, spawnFlip, firstSpawnPointSet, transition, paused);
+}
+
+void TA_ObjectSet::saveObjects(TA_Snapshot &snapshot)
+{
+    // objects spawned in the last update join the others in the next one, deleted ones are gone
+    uint32_t count = objects.size() + spawnedObjects.size();
+    snapshot.buffer.sync(count);
+
+    for(auto *list : {&objects, &spawnedObjects}) {
+        for(TA_Object *object : *list) {
+            std::shared_ptr<TA_Object> &prototype = prototypes[object->id];
+            if(prototype == nullptr) {
+                size_t size = object->allocationSize;
+                prototype.reset(cloneObject(*object, objectPool.allocate(size)), [this, size](TA_Object *prototype) {
+                    prototype->~TA_Object();
+                    objectPool.release(prototype, size);
+                });
+            }
+            snapshot.prototypes.push_back(prototype);
+            snapshot.buffer.sync(object->id);
+            object->serialize(snapshot.buffer);
+        }
+    }
+}
+
+void TA_ObjectSet::loadObjects(TA_Snapshot &snapshot)
+{
+    std::vector<TA_Object*> previousObjects;
+    std::unordered_map<uint32_t, TA_Object*> unused;
+    for(auto *list : {&objects, &spawnedObjects, &deleteList}) {
+        for(TA_Object *object : *list) {
+            previousObjects.push_back(object);
+            unused[object->id] = object;
+        }
+        list->clear();
+    }
+
+    uint32_t count;
+    snapshot.buffer.sync(count);
+    for(uint32_t pos = 0; pos < count; pos ++) {
+        uint32_t id;
+        snapshot.buffer.sync(id);
+
+        TA_Object *object = nullptr;
+        auto element = unused.find(id);
+        if(element != unused.end()) {
+            object = element->second;
+            unused.erase(element);
+        }
+        else {
+            const TA_Object &prototype = *snapshot.prototypes[pos];
+            object = cloneObject(prototype, objectPool.allocate(prototype.allocationSize));
+            object->staticHitboxIds.clear();
+            prototypes[id] = snapshot.prototypes[pos];
+        }
+        object->serialize(snapshot.buffer);
+        objects.push_back(object);
+    }
+
+    // deleted in the next update like any other object, in the same order every time
+    for(TA_Object *object : previousObjects) {
+        if(unused.count(object->id)) {
+            deleteList.push_back(object);
+        }
+    }
+}
+
+namespace {
+    using ObjectCloner = TA_Object* (*)(const TA_Object &object, void *memory);
+
+    template<class T>
+    TA_Object* cloneAs(const TA_Object &object, void *memory)
+    {
+        return new(memory) T(static_cast<const T&>(object));
+    }
+
+    template<class... T>
+    std::unordered_map<std::type_index, ObjectCloner> getCloners()
+    {
+        return {{typeid(T), cloneAs<T>}...};
+    }
+}
+
+TA_Object* TA_ObjectSet::cloneObject(const TA_Object &object, void *memory)
+{
+    // every object class which can be spawned
+    static const std::unordered_map<std::type_index, ObjectCloner> cloners = getCloners<
+        TA_BatRobot, TA_BirdWalker, TA_BirdWalkerBullet, TA_Bomb, TA_BombThrower, TA_BreakableBlock, TA_Bridge,
+        TA_ConveyorBelt, TA_DeadKukku, TA_DrillMole, TA_EnemyBomb, TA_EnemyMine, TA_EnemyRock, TA_Explosion, TA_Fire,
+        TA_Flame, TA_FlameLauncher, TA_GrassBlock, TA_HoverPod, TA_ItemBox, TA_ItemLabel, TA_Jumper, TA_Leaf,
+        TA_MechaGolem, TA_MechaGolemBomb, TA_MiniSub, TA_MovingPlatform, TA_NapalmBomb, TA_NapalmFire, TA_Nezu,
+        TA_NezuBomb, TA_Particle, TA_PushableRock, TA_PushableSpring, TA_RemoteBomb, TA_Ring, TA_RockThrower,
+        TA_Speedy, TA_Splash, TA_StrongWind, TA_Transition, TA_TripleBomb, TA_VulcanGunBullet, TA_Walker,
+        TA_WalkerBullet, TA_Wind>();
+
+    auto element = cloners.find(typeid(object));
+    if(element == cloners.end()) {
+        TA::handleError("Object type %s can't be cloned", typeid(object).name());
+    }
+    return element->second(object, memory);
+}
+
+void TA_ObjectSet::deleteObject(TA_Object *object)
+{
+    prototypes.erase(object->id);
+    size_t size = object->allocationSize;
+    object->~TA_Object();
+    objectPool.release(object, size);
+}
+
 TA_ObjectSet::~TA_ObjectSet()
 {
-    for(TA_Object *currentObject : objects) {
-        delete currentObject;
+    for(auto *list : {&objects, &spawnedObjects, &deleteList}) {
+        for(TA_Object *currentObject : *list) {
+            deleteObject(currentObject);
+        }
     }
 }
@@ -7,24 +7,21 @@ void TA_BatRobot::load(TA_Point newPosition)
 {
     TA_Sprite::load("objects/bat_robot.png", 24, 16);
     TA_Sprite::loadAnimationsFromFile("objects/bat_robot.xml");
-    TA_Sprite::setAnimation("idle");
+    idleAnimation = getAnimationId("idle");
+    activeAnimation = getAnimationId("active");
+    attackAnimation = getAnimationId("attack");
+    setAnimationById(idleAnimation);
 
     position = newPosition;
     hitbox.setRectangle(TA_Point(5, 0), TA_Point(18, 14));
     updatePosition();
 }
 
-bool TA_BatRobot::checkPawnCollision(TA_Polygon &collisionHitbox)
-{
-    int flags = objectSet->checkCollision(collisionHitbox);
-    return flags & TA_COLLISION_SOLID;
-}
-
 bool TA_BatRobot::update()
 {
     switch (state) {
         case STATE_IDLE: {
-            setAnimation("idle");
+            setAnimationById(idleAnimation);
             TA_Point characterPosition = objectSet->getCharacterPosition();
             double centeredX = position.x + 12;
             if(abs(characterPosition.x - centeredX) <= 80 && characterPosition.y - position.y <= 80) {
@@ -34,7 +31,7 @@ bool TA_BatRobot::update()
         }
 
         case STATE_ACTIVE: {
-            setAnimation("active");
+            setAnimationById(activeAnimation);
             TA_Point characterPosition = objectSet->getCharacterPosition();
             timer += TA::elapsedTime;
             double centeredX = position.x + 12;
@@ -51,7 +48,7 @@ bool TA_BatRobot::update()
         }
 
         case STATE_ATTACK: {
-            setAnimation("attack");
+            setAnimationById(attackAnimation);
             velocity.y += gravity * TA::elapsedTime;
             int flags = moveAndCollide(TA_Point(5, 0), TA_Point(18, 14), velocity * TA::elapsedTime);
             if(flags & TA_GROUND_COLLISION) {
@@ -67,7 +64,7 @@ bool TA_BatRobot::update()
 
     updatePosition();
 
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_ATTACK) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_ATTACK)) {
         objectSet->spawnObject<TA_Explosion>(position + TA_Point(4, 0), 0, TA_EXPLOSION_NEUTRAL);
         objectSet->resetInstaShield();
         if(objectSet->enemyShouldDropRing()) {
@@ -96,3 +93,9 @@ double TA_BatRobot::findOptimalSpeed(double deltaY)
     }
     return left;
 }
+
+void TA_BatRobot::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity, state, timer);
+}
@@ -29,6 +29,13 @@ void TA_BirdWalker::load(double newFloorY)
 
     headSprite.loadAnimationsFromFile("objects/bird_walker/head.xml");
     feetSprite.loadAnimationsFromFile("objects/bird_walker/feet.xml");
+    headIdleAnimation = headSprite.getAnimationId("idle");
+    headLaughAnimation = headSprite.getAnimationId("laugh");
+    headTurnAnimation = headSprite.getAnimationId("turn");
+    headIdleFlipAnimation = headSprite.getAnimationId("idle_flip");
+    headLaughFlipAnimation = headSprite.getAnimationId("laugh_flip");
+    feetIdleAnimation = feetSprite.getAnimationId("idle");
+    feetWalkAnimation = feetSprite.getAnimationId("walk");
 
     headSprite.setCamera(objectSet->getLinks().camera);
     bodySprite.setCamera(objectSet->getLinks().camera);
@@ -156,7 +163,7 @@ bool TA_BirdWalker::update()
         }
 
         case TA_BIRD_WALKER_STATE_AIMING: {
-            headSprite.setAnimation("idle");
+            headSprite.setAnimationById(headIdleAnimation);
             if(timer > aimingTime) {
                 double centeredX = (aimPosition.x - 12) + bodySprite.getWidth() / 2;
                 flip = (TA::sign(int(centeredX - objectSet->getCharacterPosition().x)) < 0);
@@ -182,12 +189,12 @@ bool TA_BirdWalker::update()
         }
 
         case TA_BIRD_WALKER_STATE_LANDED: {
-            headSprite.setAnimation("laugh");
+            headSprite.setAnimationById(headLaughAnimation);
             if(timer > crouchTime) {
                 feetSprite.setFrame(0);
             }
             if(timer > laughTime) {
-                headSprite.setAnimation("idle");
+                headSprite.setAnimationById(headIdleAnimation);
                 timer = 0;
                 state = TA_BIRD_WALKER_STATE_COOL_DOWN;
             }
@@ -202,7 +209,7 @@ bool TA_BirdWalker::update()
                     state = TA_BIRD_WALKER_STATE_WALK;
                 }
                 else {
-                    headSprite.setAnimation("turn");
+                    headSprite.setAnimationById(headTurnAnimation);
                     state = TA_BIRD_WALKER_STATE_LAUGH;
                 }
             }
@@ -210,17 +217,17 @@ bool TA_BirdWalker::update()
         }
 
         case TA_BIRD_WALKER_STATE_WALK: {
-            feetSprite.setAnimation("walk");
+            feetSprite.setAnimationById(feetWalkAnimation);
             double centeredPosition = position.x + bodySprite.getWidth() / 2;
             double leftBorder = objectSet->getLinks().camera->getPosition().x + walkBorder;
             double rightBorder = objectSet->getLinks().camera->getPosition().x + TA::screenWidth - walkBorder;
 
             if((!flip && centeredPosition < leftBorder) || (flip && centeredPosition > rightBorder) || currentWalkDistance > walkDistance) {
                 timer = 0;
-                feetSprite.setAnimation("idle");
+                feetSprite.setAnimationById(feetIdleAnimation);
                 bulletCounter = 0;
                 if(jumpTimer > jumpWaitTime) {
-                    headSprite.setAnimation("turn");
+                    headSprite.setAnimationById(headTurnAnimation);
                     state = TA_BIRD_WALKER_STATE_LAUGH;
                 }
                 else if((centeredPosition < objectSet->getCharacterPosition().x) == flip
@@ -277,10 +284,10 @@ bool TA_BirdWalker::update()
 
         case TA_BIRD_WALKER_STATE_LAUGH: {
             if(!headSprite.isAnimated()) {
-                headSprite.setAnimation("laugh_flip");
+                headSprite.setAnimationById(headLaughFlipAnimation);
             }
             if(timer > laughTime) {
-                headSprite.setAnimation("idle_flip");
+                headSprite.setAnimationById(headIdleFlipAnimation);
                 timer = 0;
                 state = TA_BIRD_WALKER_STATE_FLYING_UP;
                 jumpSound.play();
@@ -303,8 +310,8 @@ bool TA_BirdWalker::update()
             if(!TA::sound::isPlaying(TA_SOUND_CHANNEL_SFX3)) {
                 explosionSound.play();
             }
-            headSprite.setAnimation("idle");
-            feetSprite.setAnimation("idle");
+            headSprite.setAnimationById(headIdleAnimation);
+            feetSprite.setAnimationById(feetIdleAnimation);
             int top, bottom = floorY, left = position.x, right = position.x + bodySprite.getWidth();
 
             switch(int(timer / (deathTime / 6))) {
@@ -397,7 +404,7 @@ void TA_BirdWalker::updateDamage()
     else if(state != TA_BIRD_WALKER_STATE_AIMING && state != TA_BIRD_WALKER_STATE_FLYING_UP &&
             state != TA_BIRD_WALKER_STATE_LANDING && state != TA_BIRD_WALKER_STATE_DEAD)
     {
-        if(objectSet->checkCollision(weakHitbox) & TA_COLLISION_ATTACK) {
+        if(objectSet->checkCollisionTypes(weakHitbox, TA_COLLISION_ATTACK)) {
             health --;
             invincibleTimeLeft = invincibleTime;
             flashTimer = 0;
@@ -430,3 +437,16 @@ void TA_BirdWalker::draw()
     bodyFlashSprite.draw();
     feetFlashSprite.draw();
 }
+
+void TA_BirdWalker::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    headSprite.serialize(buffer);
+    bodySprite.serialize(buffer);
+    feetSprite.serialize(buffer);
+    headFlashSprite.serialize(buffer);
+    bodyFlashSprite.serialize(buffer);
+    feetFlashSprite.serialize(buffer);
+    buffer.sync(state, aimPosition, flip, currentWalkDistance, bulletCounter, invincibleTimeLeft, health);
+    buffer.sync(weakHitbox, floorY, timer, jumpTimer, flashTimer);
+}
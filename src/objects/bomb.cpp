@@ -39,13 +39,6 @@ void TA_Bomb::load(TA_Point newPosition, bool newDirection, TA_BombMode newMode)
     }
 }
 
-bool TA_Bomb::checkPawnCollision(TA_Polygon &hitbox)
-{
-    int flags = 0;
-    objectSet->checkCollision(hitbox, flags);
-    return (flags & TA_COLLISION_SOLID) || (flags & TA_COLLISION_SOLID_UP) || (flags & TA_COLLISION_PUSHABLE);
-}
-
 bool TA_Bomb::update()
 {
     bool flag1 = (timer <= moveTime);
@@ -144,7 +137,7 @@ bool TA_RemoteBomb::shouldExplode()
     }
     
     hitbox.setPosition(position);
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_TARGET) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_TARGET)) {
         return true;
     }
     return false;
@@ -230,3 +223,16 @@ void TA_TripleBomb::draw() {
         TA_Bomb::draw();
     }
 }
+
+void TA_Bomb::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(mode, direction, ground, moveTime, timer, speed, crouchThrowHeight, topLeft, bottomRight);
+    buffer.sync(startVelocity, startCrouchVelocity, startHelitailVelocity, velocity);
+}
+
+void TA_TripleBomb::serialize(TA_StateBuffer &buffer)
+{
+    TA_Bomb::serialize(buffer);
+    buffer.sync(timer, active);
+}
@@ -10,6 +10,8 @@ void TA_BombThrower::load(TA_Point position, double leftX, double rightX)
 
     TA_Sprite::load("objects/bomb_thrower.png", 16, 27);
     TA_Sprite::loadAnimationsFromFile("objects/bomb_thrower.xml");
+    idleAnimation = getAnimationId("idle");
+    walkAnimation = getAnimationId("walk");
 
     hitbox.setRectangle(TA_Point(1, 2), TA_Point(14, 26));
     updatePosition();
@@ -51,7 +53,7 @@ void TA_BombThrower::updateIdle()
         return;
     }
 
-    setAnimation("idle");
+    setAnimationById(idleAnimation);
     setFlip(false);
 }
 
@@ -66,7 +68,7 @@ void TA_BombThrower::updateWalkForward()
         return;
     }
 
-    setAnimation("walk");
+    setAnimationById(walkAnimation);
     setFlip(false);
 }
 
@@ -99,7 +101,7 @@ void TA_BombThrower::updateWalkBack()
         return;
     }
 
-    setAnimation("walk");
+    setAnimationById(walkAnimation);
     setFlip(true);
 }
 
@@ -112,7 +114,7 @@ TA_Point TA_BombThrower::getDistanceToCharacter()
 
 bool TA_BombThrower::shouldBeDestroyed()
 {
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_ATTACK) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_ATTACK)) {
         return true;
     }
     return false;
@@ -146,10 +148,14 @@ bool TA_EnemyBomb::update()
     return true;
 }
 
-bool TA_EnemyBomb::checkPawnCollision(TA_Polygon &hitbox)
+void TA_BombThrower::serialize(TA_StateBuffer &buffer)
 {
-    if(objectSet->checkCollision(hitbox) & (TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP | TA_COLLISION_CHARACTER)) {
-        return true;
-    }
-    return false;
+    TA_Object::serialize(buffer);
+    buffer.sync(state, leftX, rightX, direction, timer);
+}
+
+void TA_EnemyBomb::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity);
 }
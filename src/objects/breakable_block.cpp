@@ -41,3 +41,9 @@ bool TA_BreakableBlock::update()
     }
     return true;
 }
+
+void TA_BreakableBlock::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(dropsRing);
+}
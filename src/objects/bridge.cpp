@@ -18,7 +18,7 @@ bool TA_Bridge::update()
 {
     switch(state) {
         case TA_BRIDGE_STATE_IDLE:
-            if((objectSet->checkCollision(collisionHitbox) & TA_COLLISION_CHARACTER) &&
+            if(objectSet->checkCollisionTypes(collisionHitbox, TA_COLLISION_CHARACTER) &&
                 objectSet->getLinks().character->isOnGround()) {
                 state = TA_BRIDGE_STATE_DELAY;
                 timer = 0;
@@ -64,3 +64,9 @@ int TA_Bridge::getCollisionType()
     }
     return TA_COLLISION_SOLID_UP;
 }
+
+void TA_Bridge::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(state, velocity, collisionHitbox, timer, particlesThrown);
+}
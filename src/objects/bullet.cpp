@@ -80,3 +80,15 @@ void TA_VulcanGunBullet::onDestroy()
     objectSet->spawnObject<TA_Explosion>(position - TA_Point(5, 5), 0, TA_EXPLOSION_CHARACTER);
     explosionSound.play();
 }
+
+void TA_Bullet::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity);
+}
+
+void TA_VulcanGunBullet::serialize(TA_StateBuffer &buffer)
+{
+    TA_Bullet::serialize(buffer);
+    buffer.sync(timer);
+}
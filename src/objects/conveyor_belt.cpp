@@ -5,3 +5,9 @@ void TA_ConveyorBelt::load(TA_Point topLeft, TA_Point bottomRight, bool directio
     hitbox.setRectangle(topLeft, bottomRight);
     collisionType = (direction ? TA_COLLISION_CONVEYOR_BELT_RIGHT : TA_COLLISION_CONVEYOR_BELT_LEFT);
 }
+
+void TA_ConveyorBelt::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(collisionType);
+}
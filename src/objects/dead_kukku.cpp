@@ -26,3 +26,9 @@ bool TA_DeadKukku::update()
     }
     return true;
 }
+
+void TA_DeadKukku::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity, timer);
+}
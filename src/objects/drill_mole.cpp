@@ -72,7 +72,7 @@ bool TA_DrillMole::shouldBeDestroyed()
     if(getStateAndTime().first != STATE_IDLE_UP) {
         return false;
     }
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_ATTACK) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_ATTACK)) {
         return true;
     }
     return false;
@@ -86,3 +86,9 @@ void TA_DrillMole::destroy()
         objectSet->spawnObject<TA_Ring>(position + TA_Point(7, 9));
     }
 }
+
+void TA_DrillMole::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(startY, timer);
+}
@@ -28,10 +28,16 @@ bool TA_EnemyMine::update()
     position = startPosition + delta;
     updatePosition();
 
-    if(objectSet->checkCollision(hitbox) & (TA_COLLISION_ATTACK | TA_COLLISION_CHARACTER)) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_ATTACK | TA_COLLISION_CHARACTER)) {
         objectSet->spawnObject<TA_Explosion>(position - TA_Point(1, 1), 0, TA_EXPLOSION_ENEMY);
         return false;
     }
     
     return true;
 }
+
+void TA_EnemyMine::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(startPosition, timer);
+}
@@ -42,3 +42,9 @@ void TA_Explosion::draw()
         TA_Sprite::draw();
     }
 }
+
+void TA_Explosion::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(type, timer, delay);
+}
@@ -63,3 +63,9 @@ void TA_Fire::updateAlpha()
     double factor = TA::linearInterpolation(128, 255, alphaTimer / alphaPeriod);
     TA_Sprite::setAlpha(factor);
 }
+
+void TA_Fire::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(timer, alphaTimer, flip);
+}
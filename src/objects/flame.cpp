@@ -49,3 +49,15 @@ bool TA_FlameLauncher::update()
 
     return true;
 }
+
+void TA_Flame::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(startY, speed);
+}
+
+void TA_FlameLauncher::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(timer, startSpeed, active);
+}
@@ -11,7 +11,7 @@ void TA_GrassBlock::load(TA_Point position, std::string texture)
 
 bool TA_GrassBlock::update()
 {
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_NAPALM) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_NAPALM)) {
         breakSound.play();
         return false;
     }
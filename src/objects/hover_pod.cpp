@@ -60,3 +60,9 @@ bool TA_HoverPod::update()
     }
     return true;
 }
+
+void TA_HoverPod::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(direction, idle, rangeLeft, rangeRight);
+}
@@ -92,12 +92,6 @@ void TA_ItemBox::updateFall()
     }
 }
 
-bool TA_ItemBox::checkPawnCollision(TA_Polygon &hitbox)
-{
-    int flags = objectSet->checkCollision(hitbox);
-    return (flags & (TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP)) != 0;
-}
-
 void TA_ItemBox::updateUnpack()
 {
     timer += TA::elapsedTime;
@@ -265,3 +259,15 @@ void TA_ItemLabel::draw()
 {
     font.drawText(currentPosition, name);
 }
+
+void TA_ItemBox::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(state, itemNumber, timer, velocity);
+}
+
+void TA_ItemLabel::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(currentPosition, timer);
+}
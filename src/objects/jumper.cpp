@@ -8,6 +8,7 @@ void TA_Jumper::load(TA_Point position)
 
     TA_Sprite::load("objects/jumper.png", 16, 31);
     TA_Sprite::loadAnimationsFromFile("objects/jumper.xml");
+    jumpAnimation = getAnimationId("jump");
 
     hitbox.setRectangle(TA_Point(1, 1), TA_Point(15, 31));
     updatePosition();
@@ -38,7 +39,7 @@ bool TA_Jumper::update()
 
 void TA_Jumper::updateIdle()
 {
-    setAnimation("jump");
+    setAnimationById(jumpAnimation);
     updateDirection();
     
     if(isCloseToCharacter()) {
@@ -86,7 +87,7 @@ void TA_Jumper::setJumpVelocity()
 
 void TA_Jumper::updateJump()
 {
-    setAnimation("jump");
+    setAnimationById(jumpAnimation);
 
     velocity.y += gravity * TA::elapsedTime;
     int flags = moveAndCollide(TA_Point(4, 1), TA_Point(12, 31), velocity * TA::elapsedTime);
@@ -116,18 +117,9 @@ bool TA_Jumper::isCloseToCharacter()
     return abs(distance.x) <= 128 && abs(distance.y) <= 96;
 }
 
-bool TA_Jumper::checkPawnCollision(TA_Polygon &hitbox)
-{
-    int flags = objectSet->checkCollision(hitbox);
-    if(flags & (TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP)) {
-        return true;
-    }
-    return false;
-}
-
 bool TA_Jumper::shouldBeDestroyed()
 {
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_ATTACK) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_ATTACK)) {
         return true;
     }
     return false;
@@ -138,3 +130,9 @@ void TA_Jumper::destroy()
     objectSet->spawnObject<TA_DeadKukku>(position - TA_Point(4, 1));
     objectSet->resetInstaShield();
 }
+
+void TA_Jumper::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(state, velocity, direction, timer);
+}
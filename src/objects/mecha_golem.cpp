@@ -506,7 +506,7 @@ void TA_MechaGolem::updateDamage()
         return;
     }
 
-    if((objectSet->checkCollision(hitboxVector[HITBOX_WEAK].hitbox) & TA_COLLISION_ATTACK) == 0) {
+    if(objectSet->checkCollisionTypes(hitboxVector[HITBOX_WEAK].hitbox, TA_COLLISION_ATTACK) == 0) {
         return;
     }
     if(state == STATE_BLOW || state == STATE_FALL || state == STATE_DEFEATED) {
@@ -585,3 +585,17 @@ void TA_MechaGolem::drawArm()
         armPartSprite.draw();
     }
 }
+
+void TA_MechaGolem::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    headSprite.serialize(buffer);
+    bodySprite.serialize(buffer);
+    leftFootSprite.serialize(buffer);
+    rightFootSprite.serialize(buffer);
+    headFlashSprite.serialize(buffer);
+    armSprite.serialize(buffer);
+    armPartSprite.serialize(buffer);
+    buffer.sync(state, previousState, armPosition, armTarget, timer, startX, speed, invincibleTimer, health);
+    buffer.sync(secondPhase);
+}
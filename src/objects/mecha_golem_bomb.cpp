@@ -21,3 +21,9 @@ bool TA_MechaGolemBomb::update()
 
     return true;
 }
+
+void TA_MechaGolemBomb::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(speed);
+}
@@ -21,7 +21,7 @@ bool TA_MiniSub::update()
         updateAttack();
     }
 
-    if(objectSet->checkCollision(hitbox) & (TA_COLLISION_CHARACTER | TA_COLLISION_ATTACK)) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_CHARACTER | TA_COLLISION_ATTACK)) {
         objectSet->spawnObject<TA_DeadKukku>(position);
         return false;
     }
@@ -48,3 +48,9 @@ void TA_MiniSub::updateAttack()
     position.x -= speed * TA::elapsedTime * (flip ? -1 : 1);
     timer += TA::elapsedTime;
 }
+
+void TA_MiniSub::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(idle, flip, timer);
+}
@@ -65,7 +65,7 @@ bool TA_MovingPlatform::characterIsOnTop()
     topHitbox.setRectangle(TA_Point(0, -0.01), TA_Point(32, 0.01));
     topHitbox.setPosition(prevPosition);
 
-    if((objectSet->checkCollision(topHitbox) & TA_COLLISION_CHARACTER) &&
+    if(objectSet->checkCollisionTypes(topHitbox, TA_COLLISION_CHARACTER) &&
         objectSet->getLinks().character->isOnGround() &&
         !objectSet->getLinks().character->isClimbing()) {
         return true;
@@ -97,3 +97,9 @@ int TA_MovingPlatform::getCollisionType()
     }
     return TA_COLLISION_MOVING_PLATFORM;
 }
+
+void TA_MovingPlatform::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(startPosition, endPosition, prevPosition, idle, reverse);
+}
@@ -21,15 +21,6 @@ void TA_NapalmFire::load(TA_Point position, double xsp)
     updatePosition();
 }
 
-bool TA_NapalmFire::checkPawnCollision(TA_Polygon &hitbox)
-{
-    int flags = objectSet->checkCollision(hitbox);
-    if(flags & (TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP | TA_COLLISION_PUSHABLE)) {
-        return true;
-    }
-    return false;
-}
-
 bool TA_NapalmFire::update()
 {
     int flags = moveAndCollide(topLeft, bottomRight, velocity * TA::elapsedTime, true);
@@ -44,3 +35,9 @@ bool TA_NapalmFire::update()
     }
     return true;
 }
+
+void TA_NapalmFire::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity, topLeft, bottomRight);
+}
@@ -9,7 +9,9 @@ void TA_Nezu::load(TA_Point position)
 
     TA_Sprite::load("objects/nezu.png", 16, 16);
     TA_Sprite::loadAnimationsFromFile("objects/nezu.xml");
-    TA_Sprite::setAnimation("idle");
+    idleAnimation = getAnimationId("idle");
+    walkAnimation = getAnimationId("walk");
+    setAnimationById(idleAnimation);
 
     hitbox.setRectangle(TA_Point(2, 3), TA_Point(13, 14));
     updatePosition();
@@ -39,7 +41,7 @@ bool TA_Nezu::update()
     if(isGoingToFall()) {
         state = STATE_FALL;
     }
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_ATTACK) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_ATTACK)) {
         destroy();
         return false;
     }
@@ -57,7 +59,7 @@ void TA_Nezu::destroy()
 
 void TA_Nezu::updateIdle()
 {
-    setAnimation("idle");
+    setAnimationById(idleAnimation);
     setFlip(false);
     TA_Point distance = getDistanceToCharacter();
     if(abs(distance.x) <= 54 && abs(distance.y) <= 32) {
@@ -68,7 +70,7 @@ void TA_Nezu::updateIdle()
 
 void TA_Nezu::updateWalk()
 {
-    setAnimation("walk");
+    setAnimationById(walkAnimation);
     setFlip(direction);
 
     TA_Point newPosition = position;
@@ -88,7 +90,7 @@ void TA_Nezu::updateWalk()
 
 void TA_Nezu::updateAttack()
 {
-    setAnimation("idle");
+    setAnimationById(idleAnimation);
     setFlip(false);
 
     timer += TA::elapsedTime;
@@ -176,7 +178,7 @@ bool TA_Nezu::isGoingToFall()
     groundHitbox.setRectangle(TA_Point(2, 15), TA_Point(14, 17));
     groundHitbox.setPosition(position);
 
-    if((objectSet->checkCollision(groundHitbox) & (TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP)) == 0) {
+    if(objectSet->checkCollisionTypes(groundHitbox, TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP) == 0) {
         return true;
     }
     return false;
@@ -198,3 +200,15 @@ bool TA_NezuBomb::update()
     }
     return true;
 }
+
+void TA_Nezu::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(state, direction, bombPlaced, timer, fallSpeed);
+}
+
+void TA_NezuBomb::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(timer);
+}
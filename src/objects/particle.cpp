@@ -27,3 +27,9 @@ bool TA_Particle::update()
     }
     return true;
 }
+
+void TA_Particle::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity, delta, delay, timer);
+}
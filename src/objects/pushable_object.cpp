@@ -20,10 +20,10 @@ bool TA_PushableObject::update()
     double speed = 0.33;
     velocity.x = 0;
     if(objectSet->getLinks().character->isOnGround()) {
-        if(objectSet->checkCollision(leftHitbox) & TA_COLLISION_CHARACTER) {
+        if(objectSet->checkCollisionTypes(leftHitbox, TA_COLLISION_CHARACTER)) {
             velocity.x = speed;
         }
-        else if(objectSet->checkCollision(rightHitbox) & TA_COLLISION_CHARACTER) {
+        else if(objectSet->checkCollisionTypes(rightHitbox, TA_COLLISION_CHARACTER)) {
             velocity.x = -speed;
         }
     }
@@ -38,15 +38,6 @@ bool TA_PushableObject::update()
     return true;
 }
 
-bool TA_PushableObject::checkPawnCollision(TA_Polygon &hitbox)
-{
-    int flags = objectSet->checkCollision(hitbox);
-    if((flags & TA_COLLISION_SOLID) || (flags & TA_COLLISION_SOLID_UP)) {
-        return true;
-    }
-    return false;
-}
-
 void TA_PushableSpring::load(TA_Point newPosition)
 {
     TA_PushableObject::load("objects/spring.png", newPosition);
@@ -75,3 +66,15 @@ void TA_PushableSpring::draw()
         TA_PushableObject::draw();
     }
 }
+
+void TA_PushableObject::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity);
+}
+
+void TA_PushableSpring::serialize(TA_StateBuffer &buffer)
+{
+    TA_PushableObject::serialize(buffer);
+    springBounceSprite.serialize(buffer);
+}
@@ -27,12 +27,6 @@ void TA_Ring::loadStationary(TA_Point position) {
     stationary = true;
 }
 
-bool TA_Ring::checkPawnCollision(TA_Polygon &hitbox) {
-    int flags;
-    objectSet->checkCollision(hitbox, flags);
-    return flags & (TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP);
-}
-
 bool TA_Ring::update() {
     if(collected) {
         return isAnimated();
@@ -68,7 +62,7 @@ bool TA_Ring::update() {
 
     if(timer > delay) {
         hitbox.setPosition(position);
-        if((objectSet->checkCollision(hitbox) & TA_COLLISION_CHARACTER) != 0) {
+        if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_CHARACTER) != 0) {
             ringSound.play();
             objectSet->addRings(1);
             collected = true;
@@ -84,3 +78,9 @@ bool TA_Ring::update() {
     }
     return true;
 }
+
+void TA_Ring::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity, timer, delay, stationary, collected);
+}
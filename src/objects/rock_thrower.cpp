@@ -101,7 +101,7 @@ TA_Point TA_RockThrower::getRockVelocity()
 
 bool TA_RockThrower::shouldBeDestroyed()
 {
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_ATTACK) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_ATTACK)) {
         return true;
     }
     return false;
@@ -173,10 +173,14 @@ void TA_EnemyRock::updateCollision()
     }
 }
 
-bool TA_EnemyRock::checkPawnCollision(TA_Polygon &hitbox)
+void TA_RockThrower::serialize(TA_StateBuffer &buffer)
 {
-    if(objectSet->checkCollision(hitbox) & (TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP)) {
-        return true;
-    }
-    return false;
+    TA_Object::serialize(buffer);
+    buffer.sync(prevFrame, direction, idle, timer);
+}
+
+void TA_EnemyRock::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity, ground);
 }
@@ -402,3 +402,11 @@ void TA_Speedy::draw()
         characterPlaceholder.draw();
     }
 }
+
+void TA_Speedy::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    characterPlaceholder.serialize(buffer);
+    buffer.sync(state, velocity, timer, waiting, flyUpPhase, endSequencePhase, flyUpPhase2Y, cpPosition);
+    buffer.sync(cpVelocity);
+}
@@ -38,3 +38,9 @@ void TA_Transition::draw()
 {
     
 }
+
+void TA_Transition::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(screenState, selection, seaFox);
+}
@@ -6,6 +6,9 @@ void TA_Walker::load(TA_Point newPosition, int range, bool flip)
 {
     TA_Sprite::load("objects/pf_enemies.png", 24, 32);
     TA_Sprite::loadAnimationsFromFile("objects/pf_enemies_animations.xml");
+    idleAnimation = getAnimationId("walker_idle");
+    walkAnimation = getAnimationId("walker");
+    fireAnimation = getAnimationId("walker_fire");
     hitbox.setRectangle(TA_Point(5, 0), TA_Point(18, 26));
 
     position = newPosition;
@@ -59,7 +62,7 @@ bool TA_Walker::update()
 
 void TA_Walker::updateIdle()
 {
-    setAnimation("walker_idle");
+    setAnimationById(idleAnimation);
     TA_Point distance = getDistanceToCharacter();
     if (abs(distance.x) <= 140 && abs(distance.y) <= 90) {
         state = TA_WALKER_STATE_MOVE;
@@ -69,10 +72,10 @@ void TA_Walker::updateIdle()
 void TA_Walker::updateMove()
 {
     if (alwaysIdle) {
-        setAnimation("walker_idle");
+        setAnimationById(idleAnimation);
     }
     else {
-        setAnimation("walker");
+        setAnimationById(walkAnimation);
         if (!direction) {
             position.x += speed * TA::elapsedTime;
             if (position.x > rangeRight) {
@@ -96,10 +99,10 @@ void TA_Walker::updateMove()
 void TA_Walker::updateFire()
 {
     if(!alwaysIdle && timer < standTime) {
-        setAnimation("walker_idle");
+        setAnimationById(idleAnimation);
     }
     else {
-        setAnimation("walker_fire");
+        setAnimationById(fireAnimation);
     }
     timer += TA::elapsedTime;
     if(timer > fireTime) {
@@ -114,7 +117,7 @@ void TA_Walker::updateMoveAway()
         state = TA_WALKER_STATE_MOVE;
         return;
     }
-    setAnimation("walker");
+    setAnimationById(walkAnimation);
     if (!direction) {
         position.x -= speed * TA::elapsedTime;
         if (position.x < rangeLeft) {
@@ -161,3 +164,15 @@ bool TA_WalkerBullet::update()
     }
     return true;
 }
+
+void TA_Walker::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(rangeLeft, rangeRight, direction, velocity, timer, alwaysIdle, state);
+}
+
+void TA_WalkerBullet::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(direction);
+}
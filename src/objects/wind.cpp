@@ -26,7 +26,7 @@ bool TA_Wind::update()
 
 bool TA_Wind::shouldBlow()
 {
-    if((objectSet->checkCollision(hitbox) & TA_COLLISION_CHARACTER) == 0) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_CHARACTER) == 0) {
         return false;
     }
     if(objectSet->getLinks().character->isRemoteRobot()) {
@@ -93,7 +93,7 @@ void TA_StrongWind::load(TA_Point topLeft, TA_Point bottomRight)
 
 bool TA_StrongWind::shouldBlow()
 {
-    if(objectSet->checkCollision(hitbox) & TA_COLLISION_CHARACTER) {
+    if(objectSet->checkCollisionTypes(hitbox, TA_COLLISION_CHARACTER)) {
         blowing = true;
     }
     if(objectSet->getLinks().character->isOnGround() ||
@@ -131,3 +131,21 @@ bool TA_Leaf::update()
     }
     return true;
 }
+
+void TA_Wind::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity, timer);
+}
+
+void TA_StrongWind::serialize(TA_StateBuffer &buffer)
+{
+    TA_Wind::serialize(buffer);
+    buffer.sync(blowing);
+}
+
+void TA_Leaf::serialize(TA_StateBuffer &buffer)
+{
+    TA_Object::serialize(buffer);
+    buffer.sync(velocity, timer);
+}
@@ -5,6 +5,10 @@ void TA_OnscreenController::load()
 {
     sprites[TA_BUTTON_A].load("controls/a_button.png", 20, 22);
     sprites[TA_BUTTON_B].load("controls/b_button.png", 20, 22);
+    rewindButton = (TA::save::getParameter("rewind_seconds") > 0);
+    if(rewindButton) {
+        sprites[TA_BUTTON_REWIND].load("controls/rewind_button.png", 18, 20);
+    }
 
     arrowSprites[TA_DIRECTION_UP].load("controls/up_button.png", 18, 20);
     arrowSprites[TA_DIRECTION_DOWN].load("controls/down_button.png", 18, 20);
@@ -94,6 +98,9 @@ void TA_OnscreenController::updatePositions()
 {
     setButtonPosition(TA_BUTTON_A, TA_Point(TA::screenWidth - 35, TA::screenHeight - 25));
     setButtonPosition(TA_BUTTON_B, TA_Point(TA::screenWidth - 25, TA::screenHeight - 50));
+    if(rewindButton) {
+        setButtonPosition(TA_BUTTON_REWIND, TA_Point(TA::screenWidth - 25, TA::screenHeight - 75));
+    }
 
     if(mode == TA_ONSCREEN_CONTROLLER_DPAD) {
         setArrowButtonPosition(TA_DIRECTION_UP, TA_Point(40, TA::screenHeight - 55));
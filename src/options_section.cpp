@@ -69,7 +69,6 @@ public:
         int value = TA::save::getParameter("vsync");
         value = (value + 1) % 3;
         TA::save::setParameter("vsync", value);
-        SDL_SetRenderVSync(TA::renderer, (value == 2 ? -1 : value));
         return TA_MOVE_SOUND_SWITCH;
     }
 };
@@ -136,7 +135,7 @@ public:
 
 class TA_MapKeyboardOption : public TA_Option {
 private:
-    const std::array<std::string, 9> buttons{"up", "down", "left", "right", "a", "b", "lb", "rb", "start"};
+    const std::array<std::string, 10> buttons{"up", "down", "left", "right", "a", "b", "lb", "rb", "start", "rewind"};
 
     bool locked = false;
     int button = 0;
@@ -182,7 +181,7 @@ public:
 
 class TA_MapGamepadOption : public TA_Option {
 private:
-    const std::array<std::string, 5> buttons{"a", "b", "lb", "rb", "start"};
+    const std::array<std::string, 6> buttons{"a", "b", "lb", "rb", "start", "rewind"};
 
     bool locked = false;
     int button = 0;
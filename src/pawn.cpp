@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cassert>
+#include <random>
 #include "pawn.h"
 #include "tools.h"
 #include "geometry.h"
@@ -32,30 +34,7 @@ void TA_Pawn::moveByX()
         hitbox.setRectangle(topLeft, bottomRight);
     }
 
-    auto isOutside = [&] (double factor) {
-        hitbox.setPosition({position.x + factor * velocity.x, position.y});
-        return !checkPawnCollision(hitbox);
-    };
-
-    double left = 0, right = 1, eps = 1e-5;
-    if(!isOutside(eps * 2)) {
-        left = right = 0;
-    }
-    else if(isOutside(1)) {
-        left = right = 1;
-    }
-    else {
-        while((right - left) * std::abs(velocity.x) > eps) {
-            double mid = (left + right) / 2;
-            if (isOutside(mid)) {
-                left = mid;
-            } else {
-                right = mid;
-            }
-        }
-    }
-
-    position.x += velocity.x * left;
+    position.x += velocity.x * getMoveFactor(hitbox, {velocity.x, 0});
 }
 
 void TA_Pawn::moveByY()
@@ -71,19 +50,64 @@ void TA_Pawn::moveByY()
     TA_Polygon hitbox;
     hitbox.setRectangle(topLeft, bottomRight);
 
+    position.y += velocity.y * getMoveFactor(hitbox, {0, velocity.y});
+}
+
+double TA_Pawn::getMoveFactor(TA_Polygon &hitbox, TA_Point delta)
+{
+    if(collisionSolver == TA_PAWN_SOLVER_BISECTION || getSolidCollisionMask() == 0) {
+        return getBisectionMoveFactor(hitbox, delta);
+    }
+
+    double factor = getSweepMoveFactor(hitbox, delta);
+    if(collisionSolver == TA_PAWN_SOLVER_SWEEP_CHECKED) {
+        double bisectionFactor = getBisectionMoveFactor(hitbox, delta);
+        if(factor != bisectionFactor) {
+            TA::printWarning("Collision solvers differ at %f %f moving by %f %f: sweep %.9f, bisection %.9f",
+                position.x, position.y, delta.x, delta.y, factor, bisectionFactor);
+        }
+    }
+    return factor;
+}
+
+double TA_Pawn::getBisectionMoveFactor(TA_Polygon &hitbox, TA_Point delta)
+{
     auto isOutside = [&] (double factor) {
-        hitbox.setPosition({position.x, position.y + velocity.y * factor});
+        hitbox.setPosition(position + delta * factor);
         return !checkPawnCollision(hitbox);
     };
+    return bisectMoveFactor(isOutside, std::abs(delta.x) + std::abs(delta.y));
+}
 
-    double left = 0, right = 1, eps = 1e-5;
+double TA_Pawn::getSweepMoveFactor(TA_Polygon &hitbox, TA_Point delta)
+{
+    hitbox.setPosition(position);
+    TA_Point startTopLeft = hitbox.getTopLeft(), startBottomRight = hitbox.getBottomRight();
+    TA_Rect bounds;
+    bounds.topLeft = TA_Point(std::min(startTopLeft.x, startTopLeft.x + delta.x), std::min(startTopLeft.y, startTopLeft.y + delta.y));
+    bounds.bottomRight = TA_Point(std::max(startBottomRight.x, startBottomRight.x + delta.x), std::max(startBottomRight.y, startBottomRight.y + delta.y));
+    bounds.topLeft = bounds.topLeft - TA_Point(sweepMargin, sweepMargin);
+    bounds.bottomRight = bounds.bottomRight + TA_Point(sweepMargin, sweepMargin);
+
+    sweepCandidates.clear();
+    addCollisionCandidates(bounds, sweepCandidates);
+
+    // the same bisection, but probes test the time of impact intervals instead of querying the world
+    computeSweepIntervals(hitbox, delta);
+    return bisectMoveFactor([&](double factor) {return !isSweepBlocked(factor);}, std::abs(delta.x) + std::abs(delta.y));
+}
+
+template<typename Predicate>
+double TA_Pawn::bisectMoveFactor(Predicate isOutside, double distance)
+{
+    double left = 0, right = 1, eps = moveEpsilon;
     if(!isOutside(eps * 2)) {
-        left = right = 0;
+        return 0;
     }
-    else if(isOutside(1)) {
-        left = right = 1;
+    if(isOutside(1)) {
+        return 1;
     }
-    while((right - left) * std::abs(velocity.y) > eps) {
+    while((right - left) * distance > eps) {
         double mid = (left + right) / 2;
         if(isOutside(mid)) {
             left = mid;
@@ -92,16 +116,42 @@ void TA_Pawn::moveByY()
             right = mid;
         }
     }
-
-    position.y += velocity.y * left;
+    return left;
 }
 
 void TA_Pawn::popOut()
+{
+    bool sweep = collisionSolver != TA_PAWN_SOLVER_BISECTION && getSolidCollisionMask() != 0;
+    if(sweep) {
+        TA_Polygon hitbox;
+        hitbox.setRectangle(topLeft, bottomRight);
+        hitbox.setPosition(position);
+        TA_Rect bounds;
+        bounds.topLeft = hitbox.getTopLeft() - TA_Point(popOutDistance + sweepMargin, popOutDistance + sweepMargin);
+        bounds.bottomRight = hitbox.getBottomRight() + TA_Point(popOutDistance + sweepMargin, popOutDistance + sweepMargin);
+        sweepCandidates.clear();
+        addCollisionCandidates(bounds, sweepCandidates);
+    }
+
+    TA_Point add = getPopOutShift(sweep);
+    if(sweep && collisionSolver == TA_PAWN_SOLVER_SWEEP_CHECKED) {
+        TA_Point bisectionAdd = getPopOutShift(false);
+        if(add.x != bisectionAdd.x || add.y != bisectionAdd.y) {
+            TA::printWarning("Collision solvers differ at %f %f popping out: sweep %.9f %.9f, bisection %.9f %.9f",
+                position.x, position.y, add.x, add.y, bisectionAdd.x, bisectionAdd.y);
+        }
+    }
+    if(isGoodPosition(position + add)) {
+        position = position + add;
+    }
+}
+
+TA_Point TA_Pawn::getPopOutShift(bool sweep)
 {
     std::vector<std::pair<double, TA_Point>> directions;
     
-    for(TA_Point delta : {TA_Point(-32, 0), TA_Point(32, 0), TA_Point(0, -32), TA_Point(0, 32)}) {
-        directions.push_back({getFirstGood(delta), delta});
+    for(TA_Point delta : {TA_Point(-popOutDistance, 0), TA_Point(popOutDistance, 0), TA_Point(0, -popOutDistance), TA_Point(0, popOutDistance)}) {
+        directions.push_back({sweep ? getSweepFirstGood(delta) : getFirstGood(delta), delta});
     }
 
     int min = 0;
@@ -110,19 +160,29 @@ void TA_Pawn::popOut()
             min = pos;
         }
     }
-
-    TA_Point add = directions[min].second * directions[min].first;
-    if(isGoodPosition(position + add)) {
-        position = position + add;
-    }
+    return directions[min].second * directions[min].first;
 }
 
 double TA_Pawn::getFirstGood(TA_Point delta)
+{
+    return bisectFirstGood([&](double factor) {return isGoodPosition(position + delta * factor);}, delta.length());
+}
+
+double TA_Pawn::getSweepFirstGood(TA_Point delta)
+{
+    TA_Polygon hitbox;
+    hitbox.setRectangle(topLeft, bottomRight);
+    computeSweepIntervals(hitbox, delta);
+    return bisectFirstGood([&](double factor) {return !isSweepBlocked(factor);}, delta.length());
+}
+
+template<typename Predicate>
+double TA_Pawn::bisectFirstGood(Predicate isGood, double distance)
 {
     double left = 0, right = 1, eps = 1e-5;
-    while((right - left) * delta.length() > eps) {
+    while((right - left) * distance > eps) {
         double mid = (left + right) / 2;
-        if(isGoodPosition(position + delta * mid)) {
+        if(isGood(mid)) {
             right = mid;
         }
         else {
@@ -132,6 +192,29 @@ double TA_Pawn::getFirstGood(TA_Point delta)
     return right;
 }
 
+void TA_Pawn::computeSweepIntervals(TA_Polygon &hitbox, TA_Point delta)
+{
+    hitbox.setPosition(position);
+    sweepIntervals.clear();
+    for(const TA_CollisionHitbox &candidate : sweepCandidates) {
+        SweepInterval interval;
+        if(hitbox.getSweepInterval(candidate.polygon, delta, interval.enter, interval.exit)) {
+            interval.touching = !(hitbox.isRectangle() && candidate.polygon.isRectangle());
+            sweepIntervals.push_back(interval);
+        }
+    }
+}
+
+bool TA_Pawn::isSweepBlocked(double factor)
+{
+    for(const SweepInterval &interval : sweepIntervals) {
+        if(interval.touching ? interval.enter <= factor && factor <= interval.exit : interval.enter < factor && factor < interval.exit) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool TA_Pawn::isGoodPosition(TA_Point position)
 {
     TA_Polygon hitbox;
@@ -162,3 +245,95 @@ int TA_Pawn::getCollisionFlags(TA_Point topLeft, TA_Point bottomRight)
 
     return flags;
 }
+
+void TA_Pawn::serialize(TA_StateBuffer &buffer)
+{
+    TA_Sprite::serialize(buffer);
+    buffer.sync(position);
+}
+
+namespace {
+    class TA_ScenePawn : public TA_Pawn {
+    private:
+        const std::vector<TA_CollisionHitbox> &scene;
+
+    public:
+        TA_ScenePawn(const std::vector<TA_CollisionHitbox> &scene, TA_Point position) : scene(scene) {this->position = position;}
+        TA_Point getPosition() const {return position;}
+
+        bool checkPawnCollision(TA_Polygon &hitbox) override {
+            for(const TA_CollisionHitbox &candidate : scene) {
+                if((candidate.type & getSolidCollisionMask()) && hitbox.intersects(candidate.polygon)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        int getSolidCollisionMask() override {return TA_COLLISION_SOLID | TA_COLLISION_SOLID_UP;}
+
+        void addCollisionCandidates(TA_Rect, std::vector<TA_CollisionHitbox> &candidates) override {
+            for(const TA_CollisionHitbox &candidate : scene) {
+                if(candidate.type & getSolidCollisionMask()) {
+                    candidates.push_back(candidate);
+                }
+            }
+        }
+    };
+}
+
+bool TA_Pawn::checkSolversOnScenes()
+{
+    // fixed seed, the scenes are the same on every run
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> random(0, 1);
+    TA_PawnCollisionSolver previousSolver = collisionSolver;
+    int moves = 0, differences = 0;
+
+    for(int scene = 0; scene < 3000; scene ++) {
+        // blocks, slopes and half slopes on a 16 px grid
+        std::vector<TA_CollisionHitbox> hitboxes(12);
+        for(TA_CollisionHitbox &hitbox : hitboxes) {
+            TA_Point position(int(random(generator) * 10) * 16, int(random(generator) * 10) * 16);
+            hitbox.type = (random(generator) < 0.7 ? TA_COLLISION_SOLID : TA_COLLISION_SOLID_UP);
+            double shape = random(generator);
+            if(shape < 0.6) {
+                hitbox.polygon.setRectangle({0, 0}, {16, 16});
+            }
+            else {
+                hitbox.polygon.addVertex({0, (shape < 0.8 ? 16.0 : 8.0)});
+                hitbox.polygon.addVertex({16, 0});
+                hitbox.polygon.addVertex({16, 16});
+                hitbox.polygon.addVertex({0, 16});
+            }
+            hitbox.polygon.setPosition(position);
+        }
+
+        for(int move = 0; move < 20; move ++) {
+            TA_Point start(random(generator) * 160, random(generator) * 160);
+            TA_Point velocity((random(generator) - 0.5) * 8, (random(generator) - 0.5) * 8);
+            if(random(generator) < 0.3) {
+                start = TA_Point(int(start.x), int(start.y));
+            }
+            bool ground = random(generator) < 0.4;
+
+            TA_ScenePawn bisectionPawn(hitboxes, start), sweepPawn(hitboxes, start);
+            collisionSolver = TA_PAWN_SOLVER_BISECTION;
+            int bisectionFlags = bisectionPawn.moveAndCollide({2, 3}, {14, 27}, velocity, ground);
+            collisionSolver = TA_PAWN_SOLVER_SWEEP;
+            int sweepFlags = sweepPawn.moveAndCollide({2, 3}, {14, 27}, velocity, ground);
+            moves ++;
+
+            TA_Point bisectionPosition = bisectionPawn.getPosition(), sweepPosition = sweepPawn.getPosition();
+            if(bisectionFlags != sweepFlags || bisectionPosition.x != sweepPosition.x || bisectionPosition.y != sweepPosition.y) {
+                TA::printWarning("Collision solvers differ in scene %i from %f %f moving by %f %f: sweep %.9f %.9f, bisection %.9f %.9f",
+                    scene, start.x, start.y, velocity.x, velocity.y, sweepPosition.x, sweepPosition.y, bisectionPosition.x, bisectionPosition.y);
+                differences ++;
+            }
+        }
+    }
+
+    collisionSolver = previousSolver;
+    TA::printLog("Collision solvers: %i of %i moves differ", differences, moves);
+    return differences == 0;
+}
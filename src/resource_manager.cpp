@@ -1,24 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "SDL3_image/SDL_image.h"
 #include "resource_manager.h"
+#include "asset_pack.h"
 #include "error.h"
 #include "filesystem.h"
+#include "save.h"
 #include "tools.h"
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <unistd.h>
+#endif
+
 namespace TA { namespace resmgr {
-    std::unordered_map<std::string, SDL_Texture*> textureMap;
-    std::unordered_map<std::string, Mix_Music*> musicMap;
-    std::unordered_map<std::string, Mix_Chunk*> chunkMap;
-    std::unordered_map<std::string, std::string> assetMap;
+    template<typename T>
+    struct Resource {
+        std::shared_ptr<T> handle; // use_count() == 1 means only the cache holds it
+        size_t bytes = 0;
+        int lastScreen = 0;
+        long long lastUse = 0;
+        bool pinned = false;
+    };
+
+    struct EvictionCandidate {
+        long long lastUse;
+        size_t bytes;
+        std::function<void()> evict;
+    };
+
+    std::unordered_map<std::string, Resource<SDL_Texture>> textureMap;
+    std::unordered_map<std::string, Resource<Mix_Music>> musicMap;
+    std::unordered_map<std::string, Resource<Mix_Chunk>> chunkMap;
+    std::unordered_map<std::string, Resource<std::string>> assetMap;
+    int screenCount = 0;
+    long long useCount = 0;
+    bool preloading = false;
+
+    enum LoadJobType {
+        LOAD_TEXTURE,
+        LOAD_CHUNK,
+        LOAD_ASSET,
+        LOAD_TASK
+    };
+
+    struct LoadJob {
+        LoadJobType type = LOAD_TASK;
+        std::string filename = "";
+        std::function<void(std::string_view)> onAssetLoaded = nullptr;
+        std::function<void()> task = nullptr;
+    };
+
+    // loader threads only decode, everything above is owned by the main thread
+    struct Loader {
+        std::mutex mutex;
+        std::condition_variable jobAdded, jobFinished;
+        std::deque<LoadJob> jobs;
+        std::vector<std::thread> threads;
+        std::unordered_set<std::string> requested[LOAD_TASK], pending[LOAD_TASK];
+        std::unordered_map<std::string, SDL_Surface*> surfaces;
+        std::unordered_map<std::string, Mix_Chunk*> chunks;
+        std::unordered_map<std::string, std::string> assets;
+        bool stopping = false;
+    } loader;
+
+    constexpr int maxLoaderThreads = 4;
 
     void preloadTextures();
     void preloadChunks();
+    SDL_IOStream* openAsset(const std::string &filename);
+    long getResidentMemory();
+    void startLoader();
+    void runLoader();
+    void runJob(LoadJob &job);
+    void queueJob(LoadJob job);
+    template<typename T>
+    bool takeLoaded(LoadJobType type, std::unordered_map<std::string, T> &loaded, const std::string &filename, T &result);
+    SDL_Texture* createTexture(SDL_Surface *surface);
+    template<typename T>
+    std::shared_ptr<T> use(Resource<T> &resource);
+    Resource<SDL_Texture>& addTexture(const std::string &filename, SDL_Texture *texture);
+    template<typename T, typename Free>
+    void addEvictionCandidates(std::unordered_map<std::string, Resource<T>> &map, Free freeResource,
+        std::unordered_set<std::string> *requested, int screens, std::vector<EvictionCandidate> &candidates);
 }}
 
 void TA::resmgr::preload()
 {
+    auto startTime = std::chrono::steady_clock::now();
+    // everything loaded here is used all over the game and is never evicted
+    preloading = true;
     preloadTextures();
     preloadChunks();
+    preloading = false;
+
+    if(TA::arguments.count("--asset-stats")) {
+        // compare runs with and without --loose-assets
+        double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        std::printf("Preload from %s took %.2f ms, resident memory %ld KiB\n",
+            (TA::assetPack::isOpen() ? "asset pack" : "loose files"), time, getResidentMemory() / 1024);
+    }
+}
+
+long TA::resmgr::getResidentMemory()
+{
+    #if defined(__linux__) && !defined(__ANDROID__)
+        long pages = 0, residentPages = 0;
+        FILE *file = std::fopen("/proc/self/statm", "r");
+        if(file != nullptr) {
+            if(std::fscanf(file, "%ld %ld", &pages, &residentPages) != 2) {
+                residentPages = 0;
+            }
+            std::fclose(file);
+        }
+        return residentPages * sysconf(_SC_PAGESIZE);
+    #else
+        return -1;
+    #endif
 }
 
 void TA::resmgr::preloadTextures()
@@ -36,6 +142,9 @@ void TA::resmgr::preloadTextures()
         "walker_bullet"
     };
 
+    for(std::string name : names) {
+        prefetchTexture("objects/" + name + ".png");
+    }
     for(std::string name : names) {
         loadTexture("objects/" + name + ".png");
     }
@@ -67,85 +176,390 @@ void TA::resmgr::preloadChunks()
         "teleport"
     };
 
+    for(std::string name : names) {
+        prefetchChunk("sound/" + name + ".ogg");
+    }
     for(std::string name : names) {
         loadChunk("sound/" + name + ".ogg");
     }
 }
 
-SDL_Texture* TA::resmgr::loadTexture(std::string filename)
+SDL_IOStream* TA::resmgr::openAsset(const std::string &filename)
+{
+    std::string_view packed = TA::assetPack::getAsset(filename);
+    if(!packed.empty()) {
+        return SDL_IOFromConstMem(packed.data(), packed.size());
+    }
+    std::string path = TA::filesystem::getAssetsPath() + "/" + filename;
+    TA::filesystem::fixPath(path);
+    return SDL_IOFromFile(path.c_str(), "rb");
+}
+
+std::shared_ptr<SDL_Texture> TA::resmgr::loadTexture(std::string filename)
 {
-    filename = TA::filesystem::getAssetsPath() + "/" + filename;
     TA::filesystem::fixPath(filename);
 
     if(!textureMap.count(filename)) {
-        SDL_Surface *surface = IMG_Load(filename.c_str());
-        if(surface == nullptr) {
-            TA::handleSDLError("%s", "Failed to load image");
+        SDL_Surface *surface = nullptr;
+        if(!takeLoaded(LOAD_TEXTURE, loader.surfaces, filename, surface)) {
+            surface = IMG_Load_IO(openAsset(filename), true);
         }
-        SDL_Texture *texture = SDL_CreateTextureFromSurface(TA::renderer, surface);
-        if(texture == nullptr) {
-            TA::handleSDLError("%s", "Failed to create texture from surface");
+        if(surface == nullptr) {
+            TA::handleSDLError("Failed to load image %s", filename.c_str());
         }
-        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
-        textureMap[filename] = texture;
-        SDL_DestroySurface(surface);
+        addTexture(filename, createTexture(surface));
     }
 
-    return textureMap[filename];
+    return use(textureMap[filename]);
 }
 
-Mix_Music* TA::resmgr::loadMusic(std::string filename)
+TA::resmgr::Resource<SDL_Texture>& TA::resmgr::addTexture(const std::string &filename, SDL_Texture *texture)
+{
+    Resource<SDL_Texture> &resource = textureMap[filename];
+    float width, height;
+    SDL_GetTextureSize(texture, &width, &height);
+    resource.handle = std::shared_ptr<SDL_Texture>(texture, [](SDL_Texture*) {});
+    resource.bytes = size_t(width) * size_t(height) * 4;
+    return resource;
+}
+
+template<typename T>
+std::shared_ptr<T> TA::resmgr::use(Resource<T> &resource)
+{
+    resource.lastScreen = screenCount;
+    resource.lastUse = ++ useCount;
+    resource.pinned = resource.pinned || preloading;
+    return resource.handle;
+}
+
+SDL_Texture* TA::resmgr::createTexture(SDL_Surface *surface)
+{
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(TA::renderer, surface);
+    if(texture == nullptr) {
+        TA::handleSDLError("%s", "Failed to create texture from surface");
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+    SDL_DestroySurface(surface);
+    return texture;
+}
+
+std::shared_ptr<Mix_Music> TA::resmgr::loadMusic(std::string filename)
 {
-    filename = TA::filesystem::getAssetsPath() + "/" + filename;
     TA::filesystem::fixPath(filename);
 
     if(!musicMap.count(filename)) {
-        musicMap[filename] = Mix_LoadMUS(filename.c_str());
-        if(musicMap[filename] == nullptr) {
+        SDL_IOStream *stream = openAsset(filename);
+        // music is decoded while it plays, so the file size is what stays in memory
+        Sint64 size = (stream == nullptr ? 0 : SDL_GetIOSize(stream));
+        Mix_Music *music = Mix_LoadMUS_IO(stream, true);
+        if(music == nullptr) {
             TA::handleSDLError("%s load failed", filename.c_str());
         }
+        musicMap[filename].handle = std::shared_ptr<Mix_Music>(music, [](Mix_Music*) {});
+        musicMap[filename].bytes = std::max<Sint64>(size, 0);
     }
 
-    return musicMap[filename];
+    return use(musicMap[filename]);
 }
 
-Mix_Chunk* TA::resmgr::loadChunk(std::string filename)
+std::shared_ptr<Mix_Chunk> TA::resmgr::loadChunk(std::string filename)
 {
-    filename = TA::filesystem::getAssetsPath() + "/" + filename;
     TA::filesystem::fixPath(filename);
 
     if(!chunkMap.count(filename)) {
-        chunkMap[filename] = Mix_LoadWAV(filename.c_str());
-        if(chunkMap[filename] == nullptr) {
+        Mix_Chunk *chunk = nullptr;
+        if(!takeLoaded(LOAD_CHUNK, loader.chunks, filename, chunk)) {
+            chunk = Mix_LoadWAV_IO(openAsset(filename), true);
+        }
+        if(chunk == nullptr) {
             TA::handleSDLError("%s load failed", filename.c_str());
         }
+        chunkMap[filename].handle = std::shared_ptr<Mix_Chunk>(chunk, [](Mix_Chunk*) {});
+        chunkMap[filename].bytes = chunk->alen;
     }
 
-    return chunkMap[filename];
+    return use(chunkMap[filename]);
 }
 
-std::string TA::resmgr::loadAsset(std::string filename)
+std::string_view TA::resmgr::loadAsset(std::string filename)
 {
-    filename = TA::filesystem::getAssetsPath() + "/" + filename;
     TA::filesystem::fixPath(filename);
 
+    std::string_view packed = TA::assetPack::getAsset(filename);
+    if(!packed.empty()) {
+        return packed;
+    }
     if(!assetMap.count(filename)) {
-        assetMap[filename] = TA::filesystem::readFile(filename);
+        std::string data;
+        if(!takeLoaded(LOAD_ASSET, loader.assets, filename, data)) {
+            data = TA::filesystem::readFile(TA::filesystem::getAssetsPath() + "/" + filename);
+        }
+        assetMap[filename].bytes = data.size();
+        assetMap[filename].handle = std::make_shared<std::string>(std::move(data));
     }
 
-    return assetMap[filename];
+    return *use(assetMap[filename]);
+}
+
+void TA::resmgr::startLoader()
+{
+    int threadCount = std::clamp(int(std::thread::hardware_concurrency()) - 1, 1, maxLoaderThreads);
+    for(int thread = 0; thread < threadCount; thread ++) {
+        loader.threads.emplace_back(runLoader);
+    }
+}
+
+void TA::resmgr::runLoader()
+{
+    std::unique_lock<std::mutex> lock(loader.mutex);
+    while(true) {
+        loader.jobAdded.wait(lock, [] {return loader.stopping || !loader.jobs.empty();});
+        if(loader.stopping) {
+            return;
+        }
+        LoadJob job = std::move(loader.jobs.front());
+        loader.jobs.pop_front();
+
+        lock.unlock();
+        runJob(job);
+        lock.lock();
+
+        if(job.type != LOAD_TASK) {
+            loader.pending[job.type].erase(job.filename);
+        }
+        loader.jobFinished.notify_all();
+    }
+}
+
+void TA::resmgr::runJob(LoadJob &job)
+{
+    if(job.type == LOAD_TASK) {
+        job.task();
+    }
+    else if(job.type == LOAD_TEXTURE) {
+        if(SDL_Surface *surface = IMG_Load_IO(openAsset(job.filename), true)) {
+            std::lock_guard<std::mutex> lock(loader.mutex);
+            loader.surfaces[job.filename] = surface;
+        }
+    }
+    else if(job.type == LOAD_CHUNK) {
+        if(Mix_Chunk *chunk = Mix_LoadWAV_IO(openAsset(job.filename), true)) {
+            std::lock_guard<std::mutex> lock(loader.mutex);
+            loader.chunks[job.filename] = chunk;
+        }
+    }
+    else {
+        std::string_view data = TA::assetPack::getAsset(job.filename);
+        std::string path = TA::filesystem::getAssetsPath() + "/" + job.filename;
+        std::string fileData;
+        if(data.empty()) {
+            // readFile exits on errors, a missing file is reported when it is loaded on the main thread
+            if(!TA::filesystem::fileExists(path)) {
+                return;
+            }
+            fileData = TA::filesystem::readFile(path);
+            data = fileData;
+        }
+        if(job.onAssetLoaded) {
+            job.onAssetLoaded(data);
+        }
+        if(!fileData.empty()) {
+            std::lock_guard<std::mutex> lock(loader.mutex);
+            loader.assets[job.filename] = std::move(fileData);
+        }
+    }
+}
+
+void TA::resmgr::queueJob(LoadJob job)
+{
+    std::lock_guard<std::mutex> lock(loader.mutex);
+    if(loader.stopping) {
+        return;
+    }
+    if(loader.threads.empty()) {
+        startLoader();
+    }
+    if(job.type != LOAD_TASK) {
+        TA::filesystem::fixPath(job.filename);
+        if(!loader.requested[job.type].insert(job.filename).second) {
+            return;
+        }
+        loader.pending[job.type].insert(job.filename);
+    }
+    loader.jobs.push_back(std::move(job));
+    loader.jobAdded.notify_one();
+}
+
+template<typename T>
+bool TA::resmgr::takeLoaded(LoadJobType type, std::unordered_map<std::string, T> &loaded, const std::string &filename, T &result)
+{
+    std::unique_lock<std::mutex> lock(loader.mutex);
+    loader.requested[type].insert(filename);
+
+    // a job that hasn't started yet is decoded here instead of waiting behind the other prefetches
+    auto queued = std::find_if(loader.jobs.begin(), loader.jobs.end(), [&](const LoadJob &job) {
+        return job.type == type && job.filename == filename;
+    });
+    if(queued != loader.jobs.end()) {
+        LoadJob job = std::move(*queued);
+        loader.jobs.erase(queued);
+        lock.unlock();
+        runJob(job);
+        lock.lock();
+        loader.pending[type].erase(filename);
+        loader.jobFinished.notify_all();
+    }
+    loader.jobFinished.wait(lock, [&] {return !loader.pending[type].count(filename);});
+
+    auto element = loaded.find(filename);
+    if(element == loaded.end()) {
+        return false;
+    }
+    result = std::move(element->second);
+    loaded.erase(element);
+    return true;
+}
+
+void TA::resmgr::prefetchTexture(std::string filename)
+{
+    queueJob({LOAD_TEXTURE, filename});
+}
+
+void TA::resmgr::prefetchChunk(std::string filename)
+{
+    queueJob({LOAD_CHUNK, filename});
+}
+
+void TA::resmgr::prefetchAsset(std::string filename, std::function<void(std::string_view)> onLoaded)
+{
+    queueJob({LOAD_ASSET, filename, std::move(onLoaded)});
+}
+
+void TA::resmgr::runInBackground(std::function<void()> task)
+{
+    queueJob({LOAD_TASK, "", {}, std::move(task)});
+}
+
+void TA::resmgr::update()
+{
+    std::unordered_map<std::string, SDL_Surface*> surfaces;
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        surfaces.swap(loader.surfaces);
+    }
+    for(auto [filename, surface] : surfaces) {
+        if(textureMap.count(filename)) {
+            SDL_DestroySurface(surface);
+        }
+        else {
+            use(addTexture(filename, createTexture(surface)));
+        }
+    }
+}
+
+void TA::resmgr::collect()
+{
+    screenCount ++;
+    size_t budget = std::max(0LL, TA::save::getParameter("cache_budget")) * 1024 * 1024;
+    int screens = std::max(1LL, TA::save::getParameter("cache_screens"));
+    size_t total = getMemoryUsage().total();
+    int evicted = 0;
+
+    if(total > budget) {
+        std::vector<EvictionCandidate> candidates;
+        addEvictionCandidates(textureMap, SDL_DestroyTexture, &loader.requested[LOAD_TEXTURE], screens, candidates);
+        addEvictionCandidates(musicMap, Mix_FreeMusic, nullptr, screens, candidates);
+        addEvictionCandidates(chunkMap, Mix_FreeChunk, &loader.requested[LOAD_CHUNK], screens, candidates);
+        addEvictionCandidates(assetMap, [](std::string*) {}, &loader.requested[LOAD_ASSET], screens, candidates);
+        std::sort(candidates.begin(), candidates.end(), [](const EvictionCandidate &first, const EvictionCandidate &second) {
+            return first.lastUse < second.lastUse;
+        });
+
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        for(EvictionCandidate &candidate : candidates) {
+            if(total <= budget) {
+                break;
+            }
+            total -= candidate.bytes;
+            candidate.evict();
+            evicted ++;
+        }
+    }
+
+    if(TA::arguments.count("--asset-stats")) {
+        TA_ResourceUsage usage = getMemoryUsage();
+        std::printf("Resource cache: textures %zu KiB, music %zu KiB, sounds %zu KiB, assets %zu KiB, %i evicted\n",
+            usage.textureBytes / 1024, usage.musicBytes / 1024, usage.chunkBytes / 1024, usage.assetBytes / 1024, evicted);
+    }
+}
+
+template<typename T, typename Free>
+void TA::resmgr::addEvictionCandidates(std::unordered_map<std::string, Resource<T>> &map, Free freeResource,
+    std::unordered_set<std::string> *requested, int screens, std::vector<EvictionCandidate> &candidates)
+{
+    for(auto &[filename, resource] : map) {
+        if(resource.pinned || resource.handle.use_count() > 1 || screenCount - resource.lastScreen < screens) {
+            continue;
+        }
+        const std::string &name = filename;
+        candidates.push_back({resource.lastUse, resource.bytes, [&map, freeResource, requested, name]() {
+            freeResource(map[name].handle.get());
+            if(requested != nullptr) {
+                // allow prefetching it again
+                requested->erase(name);
+            }
+            map.erase(name);
+        }});
+    }
+}
+
+TA_ResourceUsage TA::resmgr::getMemoryUsage()
+{
+    TA_ResourceUsage usage;
+    for(auto &[filename, resource] : textureMap) {
+        usage.textureBytes += resource.bytes;
+    }
+    for(auto &[filename, resource] : musicMap) {
+        usage.musicBytes += resource.bytes;
+    }
+    for(auto &[filename, resource] : chunkMap) {
+        usage.chunkBytes += resource.bytes;
+    }
+    for(auto &[filename, resource] : assetMap) {
+        usage.assetBytes += resource.bytes;
+    }
+    return usage;
 }
 
 void TA::resmgr::quit()
 {
-    for(std::pair<std::string, SDL_Texture*> element : textureMap) {
-        SDL_DestroyTexture(element.second);
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        loader.stopping = true;
+        loader.jobAdded.notify_all();
+    }
+    for(std::thread &thread : loader.threads) {
+        thread.join();
+    }
+    for(auto [filename, surface] : loader.surfaces) {
+        SDL_DestroySurface(surface);
+    }
+    for(auto [filename, chunk] : loader.chunks) {
+        Mix_FreeChunk(chunk);
+    }
+
+    for(auto &[filename, resource] : textureMap) {
+        SDL_DestroyTexture(resource.handle.get());
     }
-    for(std::pair<std::string, Mix_Music*> element : musicMap) {
-        Mix_FreeMusic(element.second);
+    for(auto &[filename, resource] : musicMap) {
+        Mix_FreeMusic(resource.handle.get());
     }
-    for(std::pair<std::string, Mix_Chunk*> element : chunkMap) {
-        Mix_FreeChunk(element.second);
+    for(auto &[filename, resource] : chunkMap) {
+        Mix_FreeChunk(resource.handle.get());
     }
+    textureMap.clear();
+    musicMap.clear();
+    chunkMap.clear();
+    assetMap.clear();
 }
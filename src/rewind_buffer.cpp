@@ -0,0 +1,194 @@
+#include <algorithm>
+#include "rewind_buffer.h"
+#include "object_set.h"
+
+namespace {
+    void writeVarint(std::vector<unsigned char> &output, size_t value)
+    {
+        while(value >= 0x80) {
+            output.push_back((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        output.push_back(value);
+    }
+
+    size_t readVarint(const std::vector<unsigned char> &input, size_t &pos)
+    {
+        size_t value = 0;
+        for(int shift = 0; pos < input.size(); shift += 7) {
+            unsigned char byte = input[pos ++];
+            value |= size_t(byte & 0x7f) << shift;
+            if(!(byte & 0x80)) {
+                break;
+            }
+        }
+        return value;
+    }
+}
+
+void TA_RewindBuffer::push(TA_Snapshot &snapshot)
+{
+    if(capacity == 0) {
+        return;
+    }
+
+    size_t bytes = sizeof(std::shared_ptr<const Prototypes>);
+    if(lastPrototypes == nullptr || *lastPrototypes != snapshot.prototypes) {
+        lastPrototypes = makePrototypes(snapshot.prototypes);
+    }
+
+    // the delta is positional, a spawned or deleted object would shift everything after it
+    const std::vector<unsigned char> &data = snapshot.buffer.getData();
+    if(groups.empty() || groups.back().deltas.size() + 1 >= keyframeInterval ||
+        groups.back().prototypes.front() != lastPrototypes || groups.back().keyframe.size() != data.size()) {
+        groups.emplace_back();
+        groups.back().keyframe = data;
+        bytes += data.size();
+    }
+    else {
+        Group &group = groups.back();
+        group.deltas.emplace_back();
+        encode(data, group.keyframe, group.deltas.back());
+        bytes += group.deltas.back().size() + sizeof(std::vector<unsigned char>);
+    }
+    groups.back().prototypes.push_back(lastPrototypes);
+    groups.back().bytes += bytes;
+    memoryUsage += bytes;
+    size ++;
+
+    // deltas are useless without their keyframe, so whole groups are dropped
+    while(groups.size() >= 2 && size - groups.front().prototypes.size() >= capacity) {
+        size -= groups.front().prototypes.size();
+        memoryUsage -= groups.front().bytes;
+        groups.pop_front();
+    }
+}
+
+bool TA_RewindBuffer::pop(TA_Snapshot &snapshot)
+{
+    if(groups.empty()) {
+        return false;
+    }
+
+    Group &group = groups.back();
+    std::vector<unsigned char> &data = snapshot.buffer.getData();
+    size_t bytes = sizeof(std::shared_ptr<const Prototypes>);
+    if(group.deltas.empty()) {
+        data = group.keyframe;
+        bytes += group.keyframe.size();
+    }
+    else {
+        decode(group.deltas.back(), group.keyframe, data);
+        bytes += group.deltas.back().size() + sizeof(std::vector<unsigned char>);
+        group.deltas.pop_back();
+    }
+    snapshot.prototypes = *group.prototypes.back();
+    lastPrototypes = group.prototypes.back();
+    group.prototypes.pop_back();
+
+    bytes = std::min(bytes, group.bytes);
+    group.bytes -= bytes;
+    memoryUsage -= bytes;
+    if(group.prototypes.empty()) {
+        memoryUsage -= group.bytes;
+        groups.pop_back();
+    }
+    size --;
+    return true;
+}
+
+void TA_RewindBuffer::clear()
+{
+    for(const Group &group : groups) {
+        memoryUsage -= group.bytes;
+    }
+    groups.clear();
+    lastPrototypes.reset();
+    size = 0;
+}
+
+std::shared_ptr<const TA_RewindBuffer::Prototypes> TA_RewindBuffer::makePrototypes(const Prototypes &prototypes)
+{
+    memoryUsage += prototypes.size() * sizeof(std::shared_ptr<TA_Object>);
+    for(const std::shared_ptr<TA_Object> &prototype : prototypes) {
+        if(prototypeUses[prototype.get()] ++ == 0) {
+            memoryUsage += prototype->allocationSize;
+        }
+    }
+    return std::shared_ptr<const Prototypes>(new Prototypes(prototypes), [this](const Prototypes *prototypes) {
+        releasePrototypes(prototypes);
+    });
+}
+
+void TA_RewindBuffer::releasePrototypes(const Prototypes *prototypes)
+{
+    memoryUsage -= prototypes->size() * sizeof(std::shared_ptr<TA_Object>);
+    for(const std::shared_ptr<TA_Object> &prototype : *prototypes) {
+        auto element = prototypeUses.find(prototype.get());
+        if(-- element->second == 0) {
+            memoryUsage -= prototype->allocationSize;
+            prototypeUses.erase(element);
+        }
+    }
+    delete prototypes;
+}
+
+void TA_RewindBuffer::encode(const std::vector<unsigned char> &data, const std::vector<unsigned char> &keyframe, std::vector<unsigned char> &delta)
+{
+    // size, then pairs of unchanged and changed runs, changed bytes are stored XORed with the keyframe
+    static std::vector<unsigned char> output;
+    output.clear();
+    writeVarint(output, data.size());
+
+    auto getDifference = [&](size_t pos) -> unsigned char {
+        return data[pos] ^ (pos < keyframe.size() ? keyframe[pos] : 0);
+    };
+
+    size_t pos = 0;
+    while(pos < data.size()) {
+        size_t unchangedStart = pos;
+        while(pos < data.size() && getDifference(pos) == 0) {
+            pos ++;
+        }
+
+        // a changed run ends at a few unchanged bytes, shorter gaps are cheaper to keep
+        size_t changedStart = pos, unchanged = 0;
+        while(pos < data.size() && unchanged < 4) {
+            unchanged = (getDifference(pos) == 0 ? unchanged + 1 : 0);
+            pos ++;
+        }
+        if(unchanged == 4) {
+            pos -= unchanged;
+        }
+
+        writeVarint(output, changedStart - unchangedStart);
+        writeVarint(output, pos - changedStart);
+        for(size_t changed = changedStart; changed < pos; changed ++) {
+            output.push_back(getDifference(changed));
+        }
+    }
+
+    delta.assign(output.begin(), output.end());
+}
+
+void TA_RewindBuffer::decode(const std::vector<unsigned char> &delta, const std::vector<unsigned char> &keyframe, std::vector<unsigned char> &data)
+{
+    size_t deltaPos = 0;
+    data.resize(readVarint(delta, deltaPos));
+
+    auto getKeyframeByte = [&](size_t pos) -> unsigned char {
+        return (pos < keyframe.size() ? keyframe[pos] : 0);
+    };
+
+    size_t pos = 0;
+    while(pos < data.size() && deltaPos < delta.size()) {
+        size_t unchanged = readVarint(delta, deltaPos);
+        size_t changed = readVarint(delta, deltaPos);
+        for(size_t end = std::min(pos + unchanged, data.size()); pos < end; pos ++) {
+            data[pos] = getKeyframeByte(pos);
+        }
+        for(size_t end = std::min(pos + changed, data.size()); pos < end && deltaPos < delta.size(); pos ++) {
+            data[pos] = delta[deltaPos ++] ^ getKeyframeByte(pos);
+        }
+    }
+}
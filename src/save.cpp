@@ -1,15 +1,33 @@
-#include <map>
+#include <algorithm>
 #include <sstream>
 #include <filesystem>
+#include <unordered_map>
 #include <vector>
 #include "save.h"
 #include "filesystem.h"
+#include "asset_pack.h"
 #include "error.h"
+#include "state_buffer.h"
 
 namespace TA { namespace save {
+    struct Parameter {
+        std::string name;
+        long long value = 0;
+        bool defined = false; // handles can exist before the config is loaded
+    };
+
+    void addOptions(std::string options);
     void addOptionsFromFile(std::string filename);
     std::string getSaveFileName();
-    std::map<std::string, long long> saveMap;
+    int intern(const std::string &name);
+    void copyDefaultSave(std::string saveName, bool overwrite);
+
+    std::vector<Parameter> parameters;
+    std::unordered_map<int, std::vector<std::function<void()>>> listeners;
+    std::unordered_map<std::string, int> parameterIds;
+    std::vector<std::string> saveParameterNames;
+    std::unordered_map<std::string, int> saveParameterIds;
+    std::vector<int> currentSaveIds; // parameters of saveParameterNames in the current save, only appended
     std::string currentSave = "";
 }}
 
@@ -20,29 +38,49 @@ void TA::save::addOptionsFromFile(std::string path)
         return;
     }
 
-    std::string options = TA::filesystem::readFile(path);
+    addOptions(TA::filesystem::readFile(path));
+}
+
+void TA::save::addOptions(std::string options)
+{
     std::stringstream stream;
     stream << options;
 
     std::string name;
     long long value;
     while(stream >> name >> value) {
-        saveMap[name] = value;
+        setParameter(name, value);
     }
 }
 
 void TA::save::load()
 {
-    std::string defaultConfigPath = TA::filesystem::getAssetsPath() + "/default_config";
-    addOptionsFromFile(defaultConfigPath);
+    // installs with an asset pack don't ship the loose assets
+    std::string_view packedDefaultConfig = TA::assetPack::getAsset("default_config");
+    if(!packedDefaultConfig.empty()) {
+        addOptions(std::string(packedDefaultConfig));
+    }
+    else {
+        addOptionsFromFile(TA::filesystem::getAssetsPath() + "/default_config");
+    }
     addOptionsFromFile(getSaveFileName());
 }
 
 void TA::save::writeToFile()
 {
+    std::vector<const Parameter*> sorted;
+    for(const Parameter &parameter : parameters) {
+        if(parameter.defined) {
+            sorted.push_back(&parameter);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Parameter *first, const Parameter *second) {
+        return first->name < second->name;
+    });
+
     std::stringstream output;
-    for(auto [key, value] : saveMap) {
-        output << key << ' ' << value << std::endl;
+    for(const Parameter *parameter : sorted) {
+        output << parameter->name << ' ' << parameter->value << std::endl;
     }
 
     std::string name = getSaveFileName();
@@ -65,22 +103,93 @@ std::string TA::save::getSaveFileName()
     #endif
 }
 
+TA_ParameterHandle TA::save::getParameterHandle(std::string name)
+{
+    return {intern(name)};
+}
+
+TA_SaveParameterHandle TA::save::getSaveParameterHandle(std::string name)
+{
+    auto [element, inserted] = saveParameterIds.try_emplace(name, saveParameterNames.size());
+    if(inserted) {
+        saveParameterNames.push_back(name);
+        currentSaveIds.push_back(intern(currentSave + "/" + name));
+    }
+    return {element->second};
+}
+
+int TA::save::intern(const std::string &name)
+{
+    auto [element, inserted] = parameterIds.try_emplace(name, parameters.size());
+    int id = element->second;
+    if(inserted) {
+        parameters.push_back({name});
+        // keeps currentSaveIds complete when a save parameter is set by name
+        if(!currentSave.empty() && name.starts_with(currentSave + "/")) {
+            getSaveParameterHandle(name.substr(currentSave.length() + 1));
+        }
+    }
+    return id;
+}
+
 long long TA::save::getParameter(std::string name)
 {
-    if(!saveMap.count(name)) {
+    auto element = parameterIds.find(name);
+    if(element == parameterIds.end() || !parameters[element->second].defined) {
         TA::handleError("Unknown parameter %s", name.c_str());
     }
-    return saveMap[name];
+    return parameters[element->second].value;
+}
+
+long long TA::save::getParameter(TA_ParameterHandle handle)
+{
+    Parameter &parameter = parameters[handle.id];
+    if(!parameter.defined) {
+        TA::handleError("Unknown parameter %s", parameter.name.c_str());
+    }
+    return parameter.value;
 }
 
 void TA::save::setParameter(std::string name, long long value)
 {
-    saveMap[name] = value;
+    setParameter(getParameterHandle(name), value);
+}
+
+void TA::save::setParameter(TA_ParameterHandle handle, long long value)
+{
+    Parameter &parameter = parameters[handle.id];
+    if(parameter.defined && parameter.value == value) {
+        return;
+    }
+    parameter.value = value;
+    parameter.defined = true;
+
+    auto element = listeners.find(handle.id);
+    if(element != listeners.end()) {
+        for(const std::function<void()> &listener : element->second) {
+            listener();
+        }
+    }
+}
+
+void TA::save::addListener(TA_ParameterHandle handle, std::function<void()> listener)
+{
+    listeners[handle.id].push_back(std::move(listener));
 }
 
 void TA::save::setCurrentSave(std::string name)
 {
     currentSave = name;
+    std::string prefix = currentSave + "/";
+    size_t count = parameters.size();
+    for(size_t parameter = 0; parameter < count; parameter ++) {
+        if(parameters[parameter].name.starts_with(prefix)) {
+            getSaveParameterHandle(parameters[parameter].name.substr(prefix.length()));
+        }
+    }
+    for(size_t parameter = 0; parameter < saveParameterNames.size(); parameter ++) {
+        currentSaveIds[parameter] = intern(currentSave + "/" + saveParameterNames[parameter]);
+    }
 }
 
 long long TA::save::getSaveParameter(std::string name, std::string saveName)
@@ -91,6 +200,11 @@ long long TA::save::getSaveParameter(std::string name, std::string saveName)
     return getParameter(saveName + "/" + name);
 }
 
+long long TA::save::getSaveParameter(TA_SaveParameterHandle handle)
+{
+    return getParameter(TA_ParameterHandle{currentSaveIds[handle.id]});
+}
+
 void TA::save::setSaveParameter(std::string name, long long value, std::string saveName)
 {
     if(saveName == "") {
@@ -99,40 +213,53 @@ void TA::save::setSaveParameter(std::string name, long long value, std::string s
     setParameter(saveName + "/" + name, value);
 }
 
-void TA::save::createSave(std::string saveName)
+void TA::save::setSaveParameter(TA_SaveParameterHandle handle, long long value)
 {
-    std::map<std::string, long long> newSaveMap = saveMap;
-    const std::string defaultSaveName = "default_save/";
-
-    for(auto item : saveMap) {
-        if(item.first.length() >= defaultSaveName.length() && item.first.substr(0, defaultSaveName.length()) == defaultSaveName) {
-            std::string itemName = saveName + "/" + item.first.substr(defaultSaveName.length(), item.first.length() - defaultSaveName.length());
-            newSaveMap[itemName] = item.second;
-        }
-    }
+    setParameter(TA_ParameterHandle{currentSaveIds[handle.id]}, value);
+}
 
-    saveMap = newSaveMap;
+void TA::save::createSave(std::string saveName)
+{
+    copyDefaultSave(saveName, true);
 }
 
 void TA::save::repairSave(std::string saveName)
 {
-    std::map<std::string, long long> newSaveMap = saveMap;
+    copyDefaultSave(saveName, false);
+}
+
+void TA::save::copyDefaultSave(std::string saveName, bool overwrite)
+{
     const std::string defaultSaveName = "default_save/";
 
-    for(auto item : saveMap) {
-        if(item.first.length() >= defaultSaveName.length() && item.first.substr(0, defaultSaveName.length()) == defaultSaveName) {
-            std::string itemName = saveName + "/" + item.first.substr(defaultSaveName.length(), item.first.length() - defaultSaveName.length());
-            if(!newSaveMap.count(itemName)) {
-                newSaveMap[itemName] = item.second;
-            }
+    // interning new names appends to parameters, so only the ones existing now are visited
+    size_t count = parameters.size();
+    for(size_t parameter = 0; parameter < count; parameter ++) {
+        if(!parameters[parameter].defined || !parameters[parameter].name.starts_with(defaultSaveName)) {
+            continue;
+        }
+        std::string itemName = saveName + "/" + parameters[parameter].name.substr(defaultSaveName.length());
+        TA_ParameterHandle handle = getParameterHandle(itemName);
+        if(overwrite || !parameters[handle.id].defined) {
+            setParameter(handle, parameters[parameter].value);
         }
     }
-
-    saveMap = newSaveMap;
 }
 
 bool TA::save::saveExists(int save)
 {
     std::string saveName = "save_" + std::to_string(save);
-    return saveMap.count(saveName + "/item_mask");
+    auto element = parameterIds.find(saveName + "/item_mask");
+    return element != parameterIds.end() && parameters[element->second].defined;
+}
+
+void TA::save::serializeCurrentSave(TA_StateBuffer &buffer)
+{
+    // save parameters are only appended, so the ones which existed when saving are the same on reading
+    uint32_t count = currentSaveIds.size();
+    buffer.sync(count);
+    for(uint32_t pos = 0; pos < count && pos < currentSaveIds.size(); pos ++) {
+        Parameter &parameter = parameters[currentSaveIds[pos]];
+        buffer.sync(parameter.value, parameter.defined);
+    }
 }
@@ -9,6 +9,7 @@
 #include "game_over_screen.h"
 #include "main_menu_screen.h"
 #include "error.h"
+#include "resource_manager.h"
 #include "save.h"
 
 void TA_ScreenStateMachine::init()
@@ -28,6 +29,7 @@ void TA_ScreenStateMachine::init()
 
 bool TA_ScreenStateMachine::update()
 {
+    shadowAlpha = 0;
     TA_ScreenState returnedState = currentScreen -> update();
     if(returnedState == TA_SCREENSTATE_QUIT) {
         returnedState = TA_SCREENSTATE_CURRENT;
@@ -40,14 +42,14 @@ bool TA_ScreenStateMachine::update()
     }
     if(neededState == TA_SCREENSTATE_CURRENT) {
         if(transitionTimer > 0) {
-            TA::drawShadow(255 * transitionTimer / transitionTime);
+            shadowAlpha = 255 * transitionTimer / transitionTime;
             transitionTimer -= TA::elapsedTime;
         }
         return false;
     }
 
     if(changeState) {
-        TA::drawShadow(255);
+        shadowAlpha = 255;
         currentScreen -> quit();
         TA::save::writeToFile();
 
@@ -82,6 +84,8 @@ bool TA_ScreenStateMachine::update()
                 break;
         }
 
+        // the previous screen is gone, so its resources are no longer referenced
+        TA::resmgr::collect();
         currentScreen -> init();
         currentState = neededState;
         neededState = TA_SCREENSTATE_CURRENT;
@@ -90,13 +94,24 @@ bool TA_ScreenStateMachine::update()
     }
 
     transitionTimer = std::max(double(0), transitionTimer) + TA::elapsedTime;
-    TA::drawShadow(255 * transitionTimer / transitionTime);
+    shadowAlpha = 255 * transitionTimer / transitionTime;
     if(transitionTimer > transitionTime) {
         changeState = true;
     }
     return false;
 }
 
+void TA_ScreenStateMachine::draw()
+{
+    // nothing is visible under a full shadow, and a screen which was just created hasn't been updated yet
+    if(currentScreen->isFixedStep() && shadowAlpha < 255) {
+        currentScreen->draw();
+    }
+    if(shadowAlpha > 0) {
+        TA::drawShadow(shadowAlpha);
+    }
+}
+
 TA_ScreenStateMachine::~TA_ScreenStateMachine()
 {
     currentScreen->quit();
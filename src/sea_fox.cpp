@@ -92,11 +92,12 @@ void TA_SeaFox::physicsStep()
 
 bool TA_SeaFox::checkPawnCollision(TA_Polygon &hitbox)
 {
-    int flags = links.objectSet->checkCollision(hitbox);
-    if(flags & TA_COLLISION_SOLID) {
-        return true;
-    }
-    return false;
+    return links.objectSet->checkCollisionTypes(hitbox, getSolidCollisionMask()) != 0;
+}
+
+void TA_SeaFox::addCollisionCandidates(TA_Rect bounds, std::vector<TA_CollisionHitbox> &candidates)
+{
+    links.objectSet->addCollisionCandidates(bounds, getSolidCollisionMask(), candidates);
 }
 
 void TA_SeaFox::updateDirection()
@@ -174,7 +175,7 @@ void TA_SeaFox::updateDamage()
     }
     setAlpha(255);
 
-    if(links.objectSet->checkCollision(hitbox) & TA_COLLISION_DAMAGE) {
+    if(links.objectSet->checkCollisionTypes(hitbox, TA_COLLISION_DAMAGE)) {
         if(TA::save::getParameter("ring_drop")) {
             dropRings();
             links.objectSet->addRings(-4);
@@ -215,3 +216,10 @@ void TA_SeaFox::updateDead()
     deadTimer += TA::elapsedTime;
     flip = (getAnimationFrame() >= 3);
 }
+
+void TA_SeaFox::serialize(TA_StateBuffer &buffer)
+{
+    TA_Pawn::serialize(buffer);
+    buffer.sync(velocity, followPosition, hitbox, drillHitbox, flip, neededFlip, dead);
+    buffer.sync(vulcanGunTimer, invincibleTimer, waterLevel, deadTimer);
+}
@@ -4,19 +4,40 @@
 #include "save.h"
 #include "error.h"
 
+namespace TA::sound {
+    std::shared_ptr<Mix_Music> currentMusic;
+}
+
 void TA::sound::playMusic(std::string filename, int repeat)
 {
-    Mix_Music* music = TA::resmgr::loadMusic(filename);
-    Mix_PlayMusic(music, repeat);
+    currentMusic = TA::resmgr::loadMusic(filename);
+    Mix_PlayMusic(currentMusic.get(), repeat);
 }
 
-void TA::sound::update()
+void TA::sound::init()
 {
-    Mix_MasterVolume(TA::save::getParameter("main_volume") * 16);
-    Mix_VolumeMusic(TA::save::getParameter("music_volume") * 8);
-    Mix_Volume(TA_SOUND_CHANNEL_SFX1, TA::save::getParameter("sfx_volume") * 16);
-    Mix_Volume(TA_SOUND_CHANNEL_SFX2, TA::save::getParameter("sfx_volume") * 16);
-    Mix_Volume(TA_SOUND_CHANNEL_SFX3, TA::save::getParameter("sfx_volume") * 16);
+    static const TA_ParameterHandle mainVolume = TA::save::getParameterHandle("main_volume");
+    static const TA_ParameterHandle musicVolume = TA::save::getParameterHandle("music_volume");
+    static const TA_ParameterHandle sfxVolume = TA::save::getParameterHandle("sfx_volume");
+
+    auto updateMainVolume = [] {
+        Mix_MasterVolume(TA::save::getParameter(mainVolume) * 16);
+    };
+    auto updateMusicVolume = [] {
+        Mix_VolumeMusic(TA::save::getParameter(musicVolume) * 8);
+    };
+    auto updateSfxVolume = [] {
+        for(int channel = 0; channel < TA_SOUND_CHANNEL_MAX; channel ++) {
+            Mix_Volume(channel, TA::save::getParameter(sfxVolume) * 16);
+        }
+    };
+
+    updateMainVolume();
+    updateMusicVolume();
+    updateSfxVolume();
+    TA::save::addListener(mainVolume, updateMainVolume);
+    TA::save::addListener(musicVolume, updateMusicVolume);
+    TA::save::addListener(sfxVolume, updateSfxVolume);
 }
 
 bool TA::sound::isPlaying(TA_SoundChannel channel)
@@ -59,7 +80,7 @@ void TA_Sound::play()
     if(chunk == nullptr) {
         return;
     }
-    Mix_PlayChannel(channel, chunk, loop);
+    Mix_PlayChannel(channel, chunk.get(), loop);
 }
 
 void TA_Sound::fadeOut(int time)
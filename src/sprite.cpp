@@ -12,7 +12,8 @@
 
 void TA_Texture::load(std::string filename)
 {
-    SDLTexture = TA::resmgr::loadTexture(filename);
+    handle = TA::resmgr::loadTexture(filename);
+    SDLTexture = handle.get();
     float floatWidth, floatHeight;
     SDL_GetTextureSize(SDLTexture, &floatWidth, &floatHeight);
     width = int(floatWidth + 0.5);
@@ -55,10 +56,31 @@ void TA_Sprite::load(std::string filename, int newFrameWidth, int newFrameHeight
         frameHeight = newFrameHeight;
     }
 
-    animation = TA_Animation(0);
+    setFrame(0);
     loaded = true;
 }
 
+void TA_Sprite::setPosition(TA_Point newPosition)
+{
+    if(!TA::stepping) {
+        positionTick = -1;
+    }
+    else if(positionTick != TA::tickCount) {
+        // the first position of a sprite isn't interpolated from anywhere
+        previousPosition = (positionTick == -1 ? newPosition : position);
+        positionTick = TA::tickCount;
+    }
+    position = newPosition;
+}
+
+TA_Point TA_Sprite::getDrawPosition()
+{
+    if(positionTick != TA::tickCount) {
+        return position;
+    }
+    return previousPosition + (position - previousPosition) * TA::interpolation;
+}
+
 void TA_Sprite::draw()
 {
     drawFrom({-1, -1, -1, -1});
@@ -70,6 +92,11 @@ void TA_Sprite::drawFrom(SDL_Rect srcRect)
         return;
     }
     updateAnimation();
+    if(TA::headless) {
+        // animations advance as if the sprite was drawn
+        updateAnimationNeeded = true;
+        return;
+    }
     
     if(srcRect.x == -1) {
         srcRect.x = (frameWidth * frame) % texture.width;
@@ -84,14 +111,14 @@ void TA_Sprite::drawFrom(SDL_Rect srcRect)
         srcRect.h = frameHeight;
     }
     
-    TA_Point cameraPosition;
+    TA_Point cameraPosition, drawPosition = getDrawPosition();
     if(camera != nullptr) {
-        cameraPosition = camera->getPosition();
+        cameraPosition = camera->getDrawPosition();
     }
 
     SDL_Rect dstRect;
-    dstRect.x = int(position.x * TA::scaleFactor + 0.5) - int(cameraPosition.x * TA::scaleFactor + 0.5);
-    dstRect.y = int(position.y * TA::scaleFactor + 0.5) - int(cameraPosition.y * TA::scaleFactor + 0.5);
+    dstRect.x = int(drawPosition.x * TA::scaleFactor + 0.5) - int(cameraPosition.x * TA::scaleFactor + 0.5);
+    dstRect.y = int(drawPosition.y * TA::scaleFactor + 0.5) - int(cameraPosition.y * TA::scaleFactor + 0.5);
     dstRect.w = srcRect.w * TA::scaleFactor;
     dstRect.h = srcRect.h * TA::scaleFactor;
     
@@ -111,34 +138,96 @@ void TA_Sprite::updateAnimation()
     if(!doUpdateAnimation || !updateAnimationNeeded) {
         return;
     }
-    if(animation.frames.size() >= 2) {
+    if(animation != nullptr && animation->frames.size() >= 2) {
+        const std::vector<int> &frames = animation->frames;
         animationTimer += TA::elapsedTime;
-        animationFrame += animationTimer / animation.delay;
-
-        if (animationFrame >= (int)animation.frames.size()) {
-            if (animation.repeatTimes != -1) {
-                animation.repeatTimes -= animationFrame / animation.frames.size();
-                if (animation.repeatTimes <= 0) {
-                    setFrame(animation.frames.back());
-                    frame = animation.frames[0];
+        animationFrame += animationTimer / animation->delay;
+
+        if (animationFrame >= (int)frames.size()) {
+            if (repeatTimesLeft != -1) {
+                repeatTimesLeft -= animationFrame / frames.size();
+                if (repeatTimesLeft <= 0) {
+                    setFrame(frames.back());
+                    frame = staticFrame;
+                    updateAnimationNeeded = false;
+                    return;
                 }
             }
-            animationFrame %= animation.frames.size();
+            animationFrame %= frames.size();
         }
 
-        animationTimer = std::fmod(animationTimer, animation.delay);
-        frame = animation.frames[animationFrame];
+        animationTimer = std::fmod(animationTimer, animation->delay);
+        frame = frames[animationFrame];
     }
-    else{
-        frame = animation.frames[0];
+    else {
+        frame = (animation != nullptr ? animation->frames[0] : staticFrame);
     }
     updateAnimationNeeded = false;
 }
 
-void TA_Sprite::loadAnimationsFromFile(std::string filename)
+void TA_Sprite::serialize(TA_StateBuffer &buffer)
+{
+    enum AnimationType : uint8_t {
+        ANIMATION_STATIC,
+        ANIMATION_SET,
+        ANIMATION_CUSTOM
+    };
+
+    AnimationType type = ANIMATION_STATIC;
+    if(animation != nullptr) {
+        bool fromSet = animationSet != nullptr && animationId != -1 && animation == &animationSet->getAnimation(animationId);
+        type = (fromSet ? ANIMATION_SET : ANIMATION_CUSTOM);
+    }
+
+    buffer.sync(type, animationId, frame, position, staticFrame, repeatTimesLeft, animationFrame, animationTimer);
+    buffer.sync(flip, hidden, updateAnimationNeeded, doUpdateAnimation, alpha);
+
+    TA_Animation custom;
+    if(type == ANIMATION_CUSTOM && !buffer.isReading()) {
+        custom = *animation;
+    }
+    if(type == ANIMATION_CUSTOM) {
+        buffer.sync(custom.frames);
+        buffer.sync(custom.delay, custom.repeatTimes);
+    }
+
+    if(buffer.isReading()) {
+        if(type == ANIMATION_STATIC) {
+            animation = nullptr;
+        }
+        else if(type == ANIMATION_SET) {
+            animation = &animationSet->getAnimation(animationId);
+        }
+        else {
+            if(customAnimation == nullptr || customAnimation->frames != custom.frames ||
+                customAnimation->delay != custom.delay || customAnimation->repeatTimes != custom.repeatTimes) {
+                customAnimation = std::make_shared<const TA_Animation>(custom);
+            }
+            animation = customAnimation.get();
+        }
+        // a restored sprite isn't interpolated from where it was before
+        previousPosition = position;
+        positionTick = -1;
+    }
+}
+
+const TA_AnimationSet* TA_AnimationSet::load(std::string filename)
+{
+    static std::unordered_map<std::string, std::unique_ptr<TA_AnimationSet>> loadedSets;
+
+    std::unique_ptr<TA_AnimationSet> &animationSet = loadedSets[filename];
+    if(!animationSet) {
+        animationSet = std::make_unique<TA_AnimationSet>();
+        animationSet->parse(filename);
+    }
+    return animationSet.get();
+}
+
+void TA_AnimationSet::parse(std::string filename)
 {
     tinyxml2::XMLDocument animationXml;
-    animationXml.Parse(TA::resmgr::loadAsset(filename).c_str());
+    std::string_view xmlData = TA::resmgr::loadAsset(filename);
+    animationXml.Parse(xmlData.data(), xmlData.size());
     tinyxml2::XMLElement *currentElement = animationXml.RootElement()->FirstChildElement("animation");
 
     while(currentElement != nullptr) {
@@ -155,29 +244,88 @@ void TA_Sprite::loadAnimationsFromFile(std::string filename)
         }
         int delay = currentElement->IntAttribute("delay", 1);
         int repeatTimes = currentElement->IntAttribute("repeatTimes", -1);
-        loadedAnimations[name] = TA_Animation(frames, delay, repeatTimes);
+
+        TA_Animation animation(frames, delay, repeatTimes);
+        if(ids.count(name)) {
+            animations[ids[name]] = animation;
+        }
+        else {
+            ids[name] = animations.size();
+            animations.push_back(animation);
+            names.push_back(name);
+        }
         currentElement = currentElement->NextSiblingElement("animation");
     }
 }
 
-void TA_Sprite::setAnimation(TA_Animation newAnimation)
+int TA_AnimationSet::getId(const std::string &name) const
 {
-    if(animation.frames == newAnimation.frames && animation.delay == newAnimation.delay) {
-        return;
+    auto iterator = ids.find(name);
+    if(iterator == ids.end()) {
+        return -1;
+    }
+    return iterator->second;
+}
+
+void TA_Sprite::loadAnimationsFromFile(std::string filename)
+{
+    animationSet = TA_AnimationSet::load(filename);
+    animationId = -1;
+}
+
+bool TA_Sprite::isCurrentAnimation(const TA_Animation &other)
+{
+    if(animation == nullptr) {
+        return other.frames.size() == 1 && other.frames[0] == staticFrame && other.delay == 1;
     }
+    return animation->frames == other.frames && animation->delay == other.delay;
+}
+
+void TA_Sprite::startAnimation(const TA_Animation *newAnimation)
+{
     animation = newAnimation;
+    repeatTimesLeft = (animation != nullptr ? animation->repeatTimes : -1);
     animationFrame = animationTimer = 0;
 }
 
-void TA_Sprite::setAnimation(std::string name)
+void TA_Sprite::setAnimation(TA_Animation newAnimation)
 {
-    if(loadedAnimations.count(name)) {
-        setAnimation(loadedAnimations[name]);
-        animationName = name;
+    if(isCurrentAnimation(newAnimation)) {
+        return;
     }
-    else {
+    if(newAnimation.frames.size() == 1 && newAnimation.delay == 1) {
+        staticFrame = newAnimation.frames[0];
+        startAnimation(nullptr);
+        return;
+    }
+    customAnimation = std::make_shared<const TA_Animation>(newAnimation);
+    startAnimation(customAnimation.get());
+}
+
+int TA_Sprite::getAnimationId(const std::string &name)
+{
+    int id = (animationSet != nullptr ? animationSet->getId(name) : -1);
+    if(id == -1) {
         TA::printWarning("Unknown animation %s", name.c_str());
     }
+    return id;
+}
+
+void TA_Sprite::setAnimationById(int id)
+{
+    if(id == -1) {
+        return;
+    }
+    const TA_Animation &newAnimation = animationSet->getAnimation(id);
+    if(!isCurrentAnimation(newAnimation)) {
+        startAnimation(&newAnimation);
+    }
+    animationId = id;
+}
+
+void TA_Sprite::setAnimation(std::string name)
+{
+    setAnimationById(getAnimationId(name));
 }
 
 void TA_Sprite::setFrame(int newFrame)
@@ -187,7 +335,7 @@ void TA_Sprite::setFrame(int newFrame)
 
 bool TA_Sprite::isAnimated()
 {
-    return animation.frames.size() >= 2;
+    return animation != nullptr && animation->frames.size() >= 2;
 }
 
 void TA_Sprite::setAlpha(int newAlpha)
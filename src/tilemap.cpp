@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 #include "SDL3/SDL.h"
 #include "tilemap.h"
@@ -8,11 +9,69 @@
 #include "resource_manager.h"
 #include "tools.h"
 #include "character.h"
+#include "level_file.h"
+
+namespace {
+    std::string getTilesetFilename(std::string tmxFilename, tinyxml2::XMLElement *tilesetElement)
+    {
+        while(!tmxFilename.empty() && tmxFilename.back() != '/') {
+            tmxFilename.pop_back();
+        }
+        return tmxFilename + tilesetElement->FirstChildElement("image")->Attribute("source");
+    }
+}
+
+void TA_Tilemap::prefetch(std::string filename)
+{
+    TA::resmgr::prefetchAsset(filename, [filename](std::string_view xmlData) {
+        tinyxml2::XMLDocument xmlFile;
+        xmlFile.Parse(xmlData.data(), xmlData.size());
+        tinyxml2::XMLElement *xmlRoot = xmlFile.FirstChildElement("map");
+        if(xmlRoot != nullptr && xmlRoot->FirstChildElement("tileset") != nullptr) {
+            TA::resmgr::prefetchTexture(getTilesetFilename(filename, xmlRoot->FirstChildElement("tileset")));
+        }
+    });
+}
+
+void TA_Tilemap::prefetch(TA_LevelFile &file)
+{
+    int width = file.readInt(), height = file.readInt(), layerCount = file.readInt();
+    file.readInt();
+    file.readInt();
+    int tileCount = file.readInt();
+    std::string textureFilename = file.readString();
+    if(file.isFailed() || width <= 0 || height <= 0 || int64_t(width) * height > INT32_MAX / 2 || layerCount <= 0) {
+        file.setFailed();
+        return;
+    }
+    TA::resmgr::prefetchTexture(textureFilename);
+
+    // skip the rest, laid out as in load
+    for(int tileId = 0; tileId < tileCount && !file.isFailed(); tileId ++) {
+        file.readInt();
+        int frameCount = file.readInt();
+        if(frameCount != 0) {
+            file.readBytes(sizeof(int32_t) * (size_t(std::max(frameCount, 0)) + 1));
+        }
+        int hitboxCount = file.readInt();
+        for(int pos = 0; pos < hitboxCount && !file.isFailed(); pos ++) {
+            int vertexCount = file.readInt();
+            file.readBytes(sizeof(double) * 2 * size_t(std::max(vertexCount, 0)) + sizeof(int32_t));
+        }
+    }
+    file.readInt();
+    int collisionLayerCount = file.readInt();
+    file.readBytes(sizeof(int32_t) * size_t(std::max(collisionLayerCount, 0)));
+    for(int layer = 0; layer < layerCount && !file.isFailed(); layer ++) {
+        file.readBytes(width * height * sizeof(int16_t) + height);
+    }
+}
 
 void TA_Tilemap::load(std::string filename) // TODO: rewrite this with TMX parser
 {
     tinyxml2::XMLDocument xmlFile;
-    xmlFile.Parse(TA::resmgr::loadAsset(filename).c_str());
+    std::string_view xmlData = TA::resmgr::loadAsset(filename);
+    xmlFile.Parse(xmlData.data(), xmlData.size());
     tinyxml2::XMLElement *xmlRoot = xmlFile.FirstChildElement("map");
     
     width = xmlRoot->IntAttribute("width");
@@ -22,42 +81,30 @@ void TA_Tilemap::load(std::string filename) // TODO: rewrite this with TMX parse
     tileHeight = xmlRoot->FirstChildElement("tileset")->IntAttribute("tileheight");
     int tileCount = xmlRoot->FirstChildElement("tileset")->IntAttribute("tilecount");
 
-    tilemap.resize(layerCount);
-    for(int layer = 0; layer < layerCount; layer ++) {
-        tilemap[layer].resize(width);
-        for(int pos = 0; pos < width; pos ++) {
-            tilemap[layer][pos].resize(height);
-        }
+    if(tileCount > INT16_MAX) {
+        TA::handleError("%s has too many tiles (%i)", filename.c_str(), tileCount);
     }
-    tileset.assign(tileCount, Tile());
+    initStorage(tileCount);
 
     auto loadTileset = [&](tinyxml2::XMLElement *tilesetElement)
     {
-        std::string textureFilename = filename;
-        while(!textureFilename.empty() && textureFilename.back() != '/') {
-            textureFilename.pop_back();
-        }
-        textureFilename += tilesetElement->FirstChildElement("image")->Attribute("source");
-
-        for(size_t tile = 0; tile < tileCount; tile += 1) {
-            tileset[tile].sprite.load(textureFilename, tileWidth, tileHeight);
-            tileset[tile].sprite.setFrame(tile);
-        }
+        loadTilesetTexture(getTilesetFilename(filename, tilesetElement));
 
         for(tinyxml2::XMLElement *tileElement = tilesetElement->FirstChildElement("tile");
             tileElement != nullptr; tileElement = tileElement->NextSiblingElement("tile"))
         {
             int tileId = tileElement->IntAttribute("id");
 
-            if(tileElement->FirstChildElement("animation") != nullptr) {
+            tinyxml2::XMLElement *animationElement = tileElement->FirstChildElement("animation");
+            if(animationElement != nullptr && animationElement->FirstChildElement("frame") != nullptr) {
                 TA_Animation animation;
-                int delayMs = tileElement->FirstChildElement("animation")->FirstChildElement("frame")->IntAttribute("duration");
+                int delayMs = animationElement->FirstChildElement("frame")->IntAttribute("duration");
                 animation.delay = int(delayMs * 60 / 1000 + 0.5);
-                for(tinyxml2::XMLElement *frameElement = tileElement->FirstChildElement("animation")->FirstChildElement("frame");
+                for(tinyxml2::XMLElement *frameElement = animationElement->FirstChildElement("frame");
                     frameElement != nullptr; frameElement = frameElement->NextSiblingElement("frame")) {
                     animation.frames.push_back(frameElement->IntAttribute("tileid"));
                 }
-                tileset[tileId].sprite.setAnimation(animation);
+                addTileAnimation(tileId, animation);
             }
 
             if(tileElement->FirstChildElement("objectgroup") != nullptr) {
@@ -73,6 +120,9 @@ void TA_Tilemap::load(std::string filename) // TODO: rewrite this with TMX parse
 
                 while(pointStream >> currentPoint.x) {
                     pointStream >> temp >> currentPoint.y;
+                    if(polygon.size() >= TA_Polygon::maxVertices) {
+                        TA::handleError("%s: tile %i hitbox has more than %i vertices", filename.c_str(), tileId, int(TA_Polygon::maxVertices));
+                    }
                     polygon.addVertex(currentPoint + startPoint);
                 }
                 if(object->FirstChildElement("properties") != nullptr) {
@@ -115,7 +165,10 @@ void TA_Tilemap::load(std::string filename) // TODO: rewrite this with TMX parse
                 if(tileX != width - 1 || tileY != height - 1) {
                     mapStream >> temp;
                 }
-                tilemap[layer][tileX][tileY] = tile - 1;
+                tilemap[layer][tileY * width + tileX] = tile - 1;
+                if(tile != 0) {
+                    nonEmptyRows[layer][tileY] = 1;
+                }
             }
         }
 
@@ -129,12 +182,178 @@ void TA_Tilemap::load(std::string filename) // TODO: rewrite this with TMX parse
     };
 
     loadTileset(xmlRoot->FirstChildElement("tileset"));
+    collisionTypeMask = TA_COLLISION_SOLID;
+    for(Tile& tile : tileset) {
+        for(Hitbox& hitbox : tile.hitboxes) {
+            collisionTypeMask |= hitbox.type;
+        }
+    }
+
     tinyxml2::XMLElement *layerElement = xmlRoot->FirstChildElement("layer");
     for(int layer = 0; layer < layerCount; layer ++) {
         loadLayer(layerElement);
         layerElement = layerElement->NextSiblingElement("layer");
     }
 
+    finishLoading();
+}
+
+void TA_Tilemap::load(TA_LevelFile &file)
+{
+    width = file.readInt();
+    height = file.readInt();
+    layerCount = file.readInt();
+    tileWidth = file.readInt();
+    tileHeight = file.readInt();
+    int tileCount = file.readInt();
+    if(file.isFailed() || width <= 0 || height <= 0 || int64_t(width) * height > INT32_MAX / 2
+        || layerCount <= 0 || tileCount < 0 || tileCount > INT16_MAX) {
+        TA::handleError("%s", "Invalid tilemap in level file");
+    }
+
+    initStorage(tileCount);
+    loadTilesetTexture(file.readString());
+
+    // ids from the file index tileset, tileFrames and the tileset texture, so they are range checked
+    auto isTileId = [&](int tileId) {return tileId >= 0 && tileId < tileCount;};
+
+    for(int tileId = 0; tileId < tileCount && !file.isFailed(); tileId ++) {
+        tileFrames[tileId] = file.readInt();
+        int frameCount = file.readInt();
+        if(!isTileId(tileFrames[tileId]) || frameCount < 0 || frameCount > tileCount) {
+            file.setFailed();
+            break;
+        }
+        if(frameCount != 0) {
+            TA_Animation animation;
+            animation.delay = file.readInt();
+            for(int frame = 0; frame < frameCount && !file.isFailed(); frame ++) {
+                animation.frames.push_back(file.readInt());
+                if(!isTileId(animation.frames.back())) {
+                    file.setFailed();
+                }
+            }
+            if(file.isFailed()) {
+                break;
+            }
+            addTileAnimation(tileId, animation);
+        }
+
+        int hitboxCount = file.readInt();
+        for(int pos = 0; pos < hitboxCount && !file.isFailed(); pos ++) {
+            Hitbox hitbox;
+            int vertexCount = file.readInt();
+            if(vertexCount < 0 || vertexCount > int(TA_Polygon::maxVertices)) {
+                file.setFailed();
+                break;
+            }
+            for(int vertex = 0; vertex < vertexCount && !file.isFailed(); vertex ++) {
+                double x = file.readDouble();
+                hitbox.polygon.addVertex(TA_Point(x, file.readDouble()));
+            }
+            hitbox.type = file.readInt();
+            tileset[tileId].hitboxes.push_back(hitbox);
+        }
+    }
+    collisionTypeMask = file.readInt();
+
+    int collisionLayerCount = file.readInt();
+    for(int pos = 0; pos < collisionLayerCount && !file.isFailed(); pos ++) {
+        collisionLayers.push_back(file.readInt());
+        if(collisionLayers.back() < 0 || collisionLayers.back() >= layerCount) {
+            file.setFailed();
+        }
+    }
+
+    for(int layer = 0; layer < layerCount; layer ++) {
+        const void *layerData = file.readBytes(width * height * sizeof(int16_t));
+        const void *rowData = file.readBytes(height);
+        if(file.isFailed()) {
+            break;
+        }
+        std::memcpy(tilemap[layer].data(), layerData, width * height * sizeof(int16_t));
+        std::memcpy(nonEmptyRows[layer].data(), rowData, height);
+        if(std::any_of(tilemap[layer].begin(), tilemap[layer].end(), [&](int16_t tile) {return tile != -1 && !isTileId(tile);})) {
+            file.setFailed();
+            break;
+        }
+    }
+
+    if(file.isFailed()) {
+        TA::handleError("%s", "Level file is truncated or invalid");
+    }
+    finishLoading();
+}
+
+void TA_Tilemap::bake(TA_LevelFileWriter &writer) const
+{
+    writer.writeInt(width);
+    writer.writeInt(height);
+    writer.writeInt(layerCount);
+    writer.writeInt(tileWidth);
+    writer.writeInt(tileHeight);
+    writer.writeInt(tileset.size());
+    writer.writeString(tilesetFilename);
+
+    for(size_t tileId = 0; tileId < tileset.size(); tileId ++) {
+        const Tile &tile = tileset[tileId];
+        writer.writeInt(tileFrames[tileId]);
+        writer.writeInt(tile.animationFrames.size());
+        if(!tile.animationFrames.empty()) {
+            writer.writeInt(animationClocks[tile.animationClock].delay);
+            for(int frame : tile.animationFrames) {
+                writer.writeInt(frame);
+            }
+        }
+
+        writer.writeInt(tile.hitboxes.size());
+        for(const Hitbox &hitbox : tile.hitboxes) {
+            writer.writeInt(hitbox.polygon.size());
+            for(size_t vertex = 0; vertex < hitbox.polygon.size(); vertex ++) {
+                writer.writeDouble(hitbox.polygon.getVertex(vertex).x);
+                writer.writeDouble(hitbox.polygon.getVertex(vertex).y);
+            }
+            writer.writeInt(hitbox.type);
+        }
+    }
+    writer.writeInt(collisionTypeMask);
+
+    writer.writeInt(collisionLayers.size());
+    for(int layer : collisionLayers) {
+        writer.writeInt(layer);
+    }
+
+    for(int layer = 0; layer < layerCount; layer ++) {
+        writer.writeBytes(tilemap[layer].data(), tilemap[layer].size() * sizeof(int16_t));
+        writer.writeBytes(nonEmptyRows[layer].data(), nonEmptyRows[layer].size());
+    }
+}
+
+void TA_Tilemap::initStorage(int tileCount)
+{
+    tilemap.assign(layerCount, std::vector<int16_t>(width * height, -1));
+    nonEmptyRows.assign(layerCount, std::vector<uint8_t>(height, 0));
+    tileset.assign(tileCount, Tile());
+    tileFrames.assign(tileCount, 0);
+    animationClocks.clear();
+    animatedTiles.clear();
+    collisionLayers.clear();
+}
+
+void TA_Tilemap::loadTilesetTexture(std::string filename)
+{
+    tilesetFilename = filename;
+    tilesetTexture.load(filename);
+
+    for(size_t tile = 0; tile < tileset.size(); tile += 1) {
+        tileset[tile].sprite.load(filename, tileWidth, tileHeight);
+        tileset[tile].sprite.setFrame(tile);
+        tileFrames[tile] = tile;
+    }
+}
+
+void TA_Tilemap::finishLoading()
+{
     borderPolygons[0].setRectangle(TA_Point(0, -16), TA_Point(width * tileWidth, 0));
     borderPolygons[1].setRectangle(TA_Point(-16, 0), TA_Point(0, height * tileHeight));
     borderPolygons[2].setRectangle(TA_Point(width * tileWidth, 0), TA_Point(width * tileWidth + 16, height * tileHeight));
@@ -142,39 +361,301 @@ void TA_Tilemap::load(std::string filename) // TODO: rewrite this with TMX parse
     if(collisionLayers.empty()) {
         collisionLayers.push_back(0);
     }
+
+    checkBatching = TA::arguments.count("--check-tile-batching");
+    destroyChunks();
+    chunkWidth = std::max(1, (TA::screenWidth + tileWidth - 1) / tileWidth);
+    chunkHeight = std::max(1, (TA::screenHeight + tileHeight - 1) / tileHeight);
+    chunkCountX = (width + chunkWidth - 1) / chunkWidth;
+    chunkCountY = (height + chunkHeight - 1) / chunkHeight;
+    chunks.assign(layerCount, std::vector<Chunk>(chunkCountX * chunkCountY));
 }
 
-void TA_Tilemap::draw(int priority)
+void TA_Tilemap::addTileAnimation(int tileId, const TA_Animation &animation)
+{
+    Tile &tile = tileset[tileId];
+    if(animation.frames.empty()) {
+        return;
+    }
+    if(animation.frames.size() < 2) {
+        tileFrames[tileId] = animation.frames[0];
+        return;
+    }
+
+    tile.animationFrames = animation.frames;
+    int length = animation.frames.size();
+    auto sameTiming = [&](const AnimationClock &clock) {
+        return clock.delay == animation.delay && clock.length == length;
+    };
+    auto clock = std::find_if(animationClocks.begin(), animationClocks.end(), sameTiming);
+    if(clock == animationClocks.end()) {
+        animationClocks.push_back({animation.delay, length});
+        clock = animationClocks.end() - 1;
+    }
+    tile.animationClock = clock - animationClocks.begin();
+    tileFrames[tileId] = animation.frames[0];
+    animatedTiles.push_back(tileId);
+}
+
+void TA_Tilemap::updateAnimations()
+{
+    for(AnimationClock &clock : animationClocks) {
+        clock.timer += TA::elapsedTime;
+        clock.frame += clock.timer / clock.delay;
+        clock.frame %= clock.length;
+        clock.timer = std::fmod(clock.timer, clock.delay);
+    }
+    updateTileFrames();
+}
+
+void TA_Tilemap::updateTileFrames()
+{
+    for(int tileId : animatedTiles) {
+        const Tile &tile = tileset[tileId];
+        tileFrames[tileId] = tile.animationFrames[animationClocks[tile.animationClock].frame];
+    }
+}
+
+TA_Tilemap::~TA_Tilemap()
+{
+    destroyChunks();
+}
+
+void TA_Tilemap::destroyChunks()
+{
+    releaseChunkTextures(true);
+    chunks.clear();
+}
+
+void TA_Tilemap::releaseChunkTextures(bool all)
+{
+    for(size_t pos = 0; pos < renderedChunks.size();) {
+        auto [layer, index] = renderedChunks[pos];
+        Chunk &chunk = chunks[layer][index];
+        if(!all && drawFrame - chunk.lastDrawFrame <= chunkLifetime) {
+            pos ++;
+            continue;
+        }
+        SDL_DestroyTexture(chunk.texture);
+        chunk.texture = nullptr;
+        renderedChunks[pos] = renderedChunks.back();
+        renderedChunks.pop_back();
+    }
+}
+
+void TA_Tilemap::drawLayer(int layer)
+{
+    // the batching check also runs headless, on the software renderer
+    if(TA::headless && !checkBatching) {
+        return;
+    }
+    int lx = 0, rx = width - 1, ly = 0, ry = height - 1;
+    if(camera != nullptr && TA::equal(position.x, 0) && TA::equal(position.y, 0)) {
+        TA_Point cameraPos = camera->getDrawPosition();
+        lx = std::max(0, static_cast<int>(cameraPos.x / tileWidth));
+        rx = std::min(width - 1, static_cast<int>((cameraPos.x + TA::screenWidth) / tileWidth));
+        ly = std::max(0, static_cast<int>(cameraPos.y / tileWidth));
+        ry = std::min(height - 1, static_cast<int>((cameraPos.y + TA::screenHeight) / tileWidth));
+    }
+    if(lx > rx || ly > ry) {
+        return;
+    }
+
+    if(checkBatching) {
+        checkTileBatching(layer, lx, rx, ly, ry);
+    }
+    if(!TA::headless) {
+        drawChunks(layer, lx, rx, ly, ry);
+    }
+}
+
+void TA_Tilemap::drawChunks(int layer, int lx, int rx, int ly, int ry)
 {
-    auto drawLayer = [&](int layer) {
-        int lx = 0, rx = width - 1, ly = 0, ry = height - 1;
-        if(camera != nullptr && TA::equal(position.x, 0) && TA::equal(position.y, 0)) {
-            TA_Point cameraPos = camera->getPosition();
-            lx = std::max(0, static_cast<int>(cameraPos.x / tileWidth));
-            rx = std::min(width - 1, static_cast<int>((cameraPos.x + TA::screenWidth) / tileWidth));
-            ly = std::max(0, static_cast<int>(cameraPos.y / tileWidth));
-            ry = std::min(height - 1, static_cast<int>((cameraPos.y + TA::screenHeight) / tileWidth));
+    // static tiles come from cached chunk textures, one blit per visible chunk,
+    // then animated tiles of those chunks go in one SDL_RenderGeometry call
+    TA_Point cameraPosition;
+    if(camera != nullptr) {
+        cameraPosition = camera->getDrawPosition();
+    }
+    int cameraX = int(cameraPosition.x * TA::scaleFactor + 0.5), cameraY = int(cameraPosition.y * TA::scaleFactor + 0.5);
+
+    for(int chunkY = ly / chunkHeight; chunkY <= ry / chunkHeight; chunkY ++) {
+        for(int chunkX = lx / chunkWidth; chunkX <= rx / chunkWidth; chunkX ++) {
+            Chunk &chunk = chunks[layer][chunkY * chunkCountX + chunkX];
+            if(chunk.texture == nullptr) {
+                renderChunk(layer, chunkX, chunkY);
+                renderedChunks.push_back({layer, chunkY * chunkCountX + chunkX});
+            }
+            chunk.lastDrawFrame = drawFrame;
+
+            // chunk textures are scaled by an integer factor with nearest filtering,
+            // so every pixel lands where TA_Sprite::drawFrom would put it
+            TA_Point chunkPosition = position + TA_Point(chunkX * chunkWidth * tileWidth, chunkY * chunkHeight * tileHeight);
+            SDL_FRect dstRect{float(int(chunkPosition.x * TA::scaleFactor + 0.5) - cameraX), float(int(chunkPosition.y * TA::scaleFactor + 0.5) - cameraY),
+                float(chunk.texture->w * TA::scaleFactor), float(chunk.texture->h * TA::scaleFactor)};
+            SDL_RenderTexture(TA::renderer, chunk.texture, nullptr, &dstRect);
+
+            for(auto [tileX, tileY] : chunk.animatedTiles) {
+                addTileVertices(getTile(layer, tileX, tileY), position + TA_Point(tileX * tileWidth, tileY * tileHeight), cameraX, cameraY, TA::scaleFactor);
+            }
         }
+    }
+    flushTileVertices();
+}
 
+void TA_Tilemap::renderChunk(int layer, int chunkX, int chunkY)
+{
+    Chunk &chunk = chunks[layer][chunkY * chunkCountX + chunkX];
+    int lx = chunkX * chunkWidth, rx = std::min(width, lx + chunkWidth) - 1;
+    int ly = chunkY * chunkHeight, ry = std::min(height, ly + chunkHeight) - 1;
+
+    chunk.texture = SDL_CreateTexture(TA::renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+        (rx - lx + 1) * tileWidth, (ry - ly + 1) * tileHeight);
+    if(chunk.texture == nullptr) {
+        TA::handleSDLError("Failed to create tilemap chunk texture, layer %i", layer);
+    }
+    SDL_SetTextureScaleMode(chunk.texture, SDL_SCALEMODE_NEAREST);
+    // tiles are blended onto a transparent texture, so its colors are already premultiplied
+    SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(TA::renderer);
+    Uint8 red, green, blue, alpha;
+    SDL_GetRenderDrawColor(TA::renderer, &red, &green, &blue, &alpha);
+    SDL_SetRenderTarget(TA::renderer, chunk.texture);
+    SDL_SetRenderDrawColor(TA::renderer, 0, 0, 0, 0);
+    SDL_RenderClear(TA::renderer);
+
+    chunk.animatedTiles.clear();
+    for(int tileY = ly; tileY <= ry; tileY ++) {
+        if(!nonEmptyRows[layer][tileY]) {
+            continue;
+        }
+        const int16_t *row = tilemap[layer].data() + tileY * width;
         for(int tileX = lx; tileX <= rx; tileX ++) {
-            for(int tileY = ly; tileY <= ry; tileY ++) {
-                if(tilemap[layer][tileX][tileY] != -1) {
-                    TA_Sprite& sprite = tileset[tilemap[layer][tileX][tileY]].sprite;
-                    sprite.setPosition(position + TA_Point(tileX * tileWidth, tileY * tileHeight));
-                    sprite.draw();
-                }
+            int tileId = row[tileX];
+            if(tileId == -1) {
+                continue;
+            }
+            if(tileset[tileId].animationClock != -1) {
+                chunk.animatedTiles.push_back({tileX, tileY});
+                continue;
+            }
+            addTileVertices(tileId, TA_Point((tileX - lx) * tileWidth, (tileY - ly) * tileHeight), 0, 0, 1);
+        }
+    }
+    flushTileVertices();
+
+    SDL_SetRenderTarget(TA::renderer, previousTarget);
+    SDL_SetRenderDrawColor(TA::renderer, red, green, blue, alpha);
+}
+
+void TA_Tilemap::addTileVertices(int tileId, TA_Point tilePosition, int cameraX, int cameraY, int scale)
+{
+    // rectangles are computed exactly as in TA_Sprite::drawFrom so the output doesn't change
+    float textureWidth = tilesetTexture.width, textureHeight = tilesetTexture.height;
+    int frame = tileFrames[tileId];
+    SDL_Rect srcRect{(tileWidth * frame) % tilesetTexture.width, (tileWidth * frame) / tilesetTexture.width * tileHeight, tileWidth, tileHeight};
+    SDL_Rect dstRect{int(tilePosition.x * scale + 0.5) - cameraX, int(tilePosition.y * scale + 0.5) - cameraY,
+        tileWidth * scale, tileHeight * scale};
+
+    SDL_FRect srcFRect, dstFRect;
+    SDL_RectToFRect(&srcRect, &srcFRect);
+    SDL_RectToFRect(&dstRect, &dstFRect);
+    float minU = srcFRect.x / textureWidth, maxU = (srcFRect.x + srcFRect.w) / textureWidth;
+    float minV = srcFRect.y / textureHeight, maxV = (srcFRect.y + srcFRect.h) / textureHeight;
+    float minX = dstFRect.x, maxX = dstFRect.x + dstFRect.w;
+    float minY = dstFRect.y, maxY = dstFRect.y + dstFRect.h;
+
+    int first = vertices.size();
+    SDL_FColor color{1, 1, 1, 1};
+    vertices.push_back({{minX, minY}, color, {minU, minV}});
+    vertices.push_back({{maxX, minY}, color, {maxU, minV}});
+    vertices.push_back({{maxX, maxY}, color, {maxU, maxV}});
+    vertices.push_back({{minX, maxY}, color, {minU, maxV}});
+    for(int offset : {0, 1, 2, 0, 2, 3}) {
+        indices.push_back(first + offset);
+    }
+}
+
+void TA_Tilemap::flushTileVertices()
+{
+    if(!indices.empty()) {
+        SDL_SetTextureAlphaMod(tilesetTexture.SDLTexture, 255);
+        SDL_RenderGeometry(TA::renderer, tilesetTexture.SDLTexture, vertices.data(), vertices.size(), indices.data(), indices.size());
+    }
+    vertices.clear();
+    indices.clear();
+}
+
+void TA_Tilemap::drawTilesBySprites(int layer, int lx, int rx, int ly, int ry)
+{
+    for(int tileY = ly; tileY <= ry; tileY ++) {
+        for(int tileX = lx; tileX <= rx; tileX ++) {
+            int tileId = getTile(layer, tileX, tileY);
+            if(tileId != -1) {
+                TA_Sprite& sprite = tileset[tileId].sprite;
+                sprite.setFrame(tileFrames[tileId]);
+                sprite.setPosition(position + TA_Point(tileX * tileWidth, tileY * tileHeight));
+                sprite.draw();
             }
         }
+    }
+}
+
+void TA_Tilemap::checkTileBatching(int layer, int lx, int rx, int ly, int ry)
+{
+    // debug: renders the layer both ways into offscreen textures and compares the pixels
+    int targetWidth = TA::screenWidth * TA::scaleFactor, targetHeight = TA::screenHeight * TA::scaleFactor;
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(TA::renderer);
+
+    auto render = [&](bool batched) {
+        SDL_Texture *texture = SDL_CreateTexture(TA::renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, targetWidth, targetHeight);
+        SDL_SetRenderTarget(TA::renderer, texture);
+        SDL_SetRenderDrawColor(TA::renderer, 0, 0, 0, 0);
+        SDL_RenderClear(TA::renderer);
+        if(batched) {
+            drawChunks(layer, lx, rx, ly, ry);
+        }
+        else {
+            drawTilesBySprites(layer, lx, rx, ly, ry);
+        }
+        SDL_Surface *surface = SDL_RenderReadPixels(TA::renderer, nullptr);
+        SDL_DestroyTexture(texture);
+        return surface;
     };
 
+    // sprites skip drawing in headless mode
+    bool headless = TA::headless;
+    TA::headless = false;
+    SDL_Surface *expected = render(false), *actual = render(true);
+    TA::headless = headless;
+    SDL_SetRenderTarget(TA::renderer, previousTarget);
+
+    if(expected == nullptr || actual == nullptr) {
+        TA::printWarning("Failed to read pixels for tile batching check");
+    }
+    else {
+        for(int y = 0; y < expected->h; y ++) {
+            if(std::memcmp((char*)expected->pixels + y * expected->pitch, (char*)actual->pixels + y * actual->pitch, expected->w * 4) != 0) {
+                TA::printWarning("Tile batching output differs from sprite drawing, layer %i, row %i", layer, y);
+                break;
+            }
+        }
+    }
+    SDL_DestroySurface(expected);
+    SDL_DestroySurface(actual);
+}
+
+void TA_Tilemap::draw(int priority)
+{
     if(priority == 0) {
         if(updateAnimation) {
-            for(size_t tile = 0; tile < tileset.size(); tile += 1) {
-                tileset[tile].sprite.setUpdateAnimation(true);
-                tileset[tile].sprite.updateAnimation();
-                tileset[tile].sprite.setUpdateAnimation(false);
-            }
+            updateAnimations();
         }
+        // render targets lose their contents on device loss or Android resume
+        drawFrame ++;
+        releaseChunkTextures(renderResetCount != TA::renderResetCount);
+        renderResetCount = TA::renderResetCount;
         for(int layer = 0; layer < std::max(1, layerCount - 1); layer ++) {
             drawLayer(layer);
         }
@@ -198,60 +679,107 @@ void TA_Tilemap::setPosition(TA_Point position)
     this->position = position;
 }
 
-int TA_Tilemap::checkCollision(TA_Polygon &polygon)
+int TA_Tilemap::checkCollision(const TA_Polygon &polygon, int mask) const
 {
-    int minX = 1e5, maxX = 0, minY = 1e5, maxY = 0;
-
-    for(int pos = 0; pos < polygon.size(); pos ++) {
-        TA_Point vertex = polygon.getVertex(pos);
-        minX = std::min(minX, int(vertex.x / tileWidth));
-        maxX = std::max(maxX, int(vertex.x / tileWidth));
-        minY = std::min(minY, int(vertex.y / tileHeight));
-        maxY = std::max(maxY, int(vertex.y / tileHeight));
+    if(polygon.empty() || (mask & collisionTypeMask) == 0) {
+        return 0;
     }
 
-    auto normalize = [&](int &value, int left, int right) {
-        value = std::max(value, left);
-        value = std::min(value, right);
+    auto normalize = [&](int value, int left, int right) {
+        return std::min(std::max(value, left), right);
     };
 
-    normalize(minX, 0, width - 1);
-    normalize(maxX, 0, width - 1);
-    normalize(minY, 0, height - 1);
-    normalize(maxY, 0, height - 1);
+    const TA_Point& topLeft = polygon.getBoundsTopLeft();
+    const TA_Point& bottomRight = polygon.getBoundsBottomRight();
+    int minX = normalize(int(topLeft.x / tileWidth), 0, width - 1);
+    int maxX = normalize(int(bottomRight.x / tileWidth), 0, width - 1);
+    int minY = normalize(int(topLeft.y / tileHeight), 0, height - 1);
+    int maxY = normalize(int(bottomRight.y / tileHeight), 0, height - 1);
 
     int flags = 0;
 
-    auto checkCollisionWithTile = [&] (int layer, int tileX, int tileY)
+    auto checkCollisionWithTile = [&] (int tileId, int tileX, int tileY)
     {
-        int tileId = tilemap[layer][tileX][tileY];
         if(tileId == -1) {
             return;
         }
 
-        for(auto& hitbox : tileset[tileId].hitboxes) {
-            hitbox.polygon.setPosition(TA_Point(tileX * tileWidth, tileY * tileHeight));
-            if(polygon.intersects(hitbox.polygon)) {
+        TA_Point tilePosition(tileX * tileWidth, tileY * tileHeight);
+        for(const auto& hitbox : tileset[tileId].hitboxes) {
+            if((flags & hitbox.type & mask) == (hitbox.type & mask)) {
+                continue;
+            }
+            // no per-tile bitmask in front of this: intersects already rejects disjoint bounds and has a
+            // rectangle fast path, and a baked 16x16 mask rejected too few probes to pay for itself
+            if(polygon.intersects(hitbox.polygon, tilePosition)) {
                 flags |= hitbox.type;
             }
         }
     };
 
     for(int layer : collisionLayers) {
-        for(int tileX = minX; tileX <= maxX; tileX ++) {
-            for(int tileY = minY; tileY <= maxY; tileY ++) {
-                checkCollisionWithTile(layer, tileX, tileY);
+        for(int tileY = minY; tileY <= maxY; tileY ++) {
+            if(!nonEmptyRows[layer][tileY]) {
+                continue;
+            }
+            const int16_t *row = tilemap[layer].data() + tileY * width;
+            for(int tileX = minX; tileX <= maxX; tileX ++) {
+                checkCollisionWithTile(row[tileX], tileX, tileY);
+                if((flags & mask) == mask) {
+                    return flags & mask;
+                }
+            }
+        }
+    }
+
+    if(mask & TA_COLLISION_SOLID) {
+        for(int pos = 0; pos < (int)borderPolygons.size(); pos ++) {
+            if(borderPolygons[pos].intersects(polygon)) {
+                flags |= TA_COLLISION_SOLID;
             }
         }
     }
 
-    for(int pos = 0; pos < (int)borderPolygons.size(); pos ++) {
-        if(borderPolygons[pos].intersects(polygon)) {
-            flags |= TA_COLLISION_SOLID;
+    return flags & mask;
+}
+
+void TA_Tilemap::addCollisionCandidates(TA_Rect bounds, int mask, std::vector<TA_CollisionHitbox> &candidates)
+{
+    auto normalize = [&](int value, int left, int right) {
+        return std::min(std::max(value, left), right);
+    };
+
+    int minX = normalize(int(bounds.topLeft.x / tileWidth), 0, width - 1);
+    int maxX = normalize(int(bounds.bottomRight.x / tileWidth), 0, width - 1);
+    int minY = normalize(int(bounds.topLeft.y / tileHeight), 0, height - 1);
+    int maxY = normalize(int(bounds.bottomRight.y / tileHeight), 0, height - 1);
+
+    for(int layer : collisionLayers) {
+        for(int tileY = minY; tileY <= maxY; tileY ++) {
+            if(!nonEmptyRows[layer][tileY]) {
+                continue;
+            }
+            const int16_t *row = tilemap[layer].data() + tileY * width;
+            for(int tileX = minX; tileX <= maxX; tileX ++) {
+                int tileId = row[tileX];
+                if(tileId == -1) {
+                    continue;
+                }
+                for(const auto& hitbox : tileset[tileId].hitboxes) {
+                    if(hitbox.type & mask) {
+                        candidates.push_back({hitbox.polygon, hitbox.type});
+                        candidates.back().polygon.setPosition(TA_Point(tileX * tileWidth, tileY * tileHeight));
+                    }
+                }
+            }
         }
     }
 
-    return flags;
+    if(mask & TA_COLLISION_SOLID) {
+        for(const TA_Polygon& polygon : borderPolygons) {
+            candidates.push_back({polygon, TA_COLLISION_SOLID});
+        }
+    }
 }
 
 void TA_Tilemap::setUpdateAnimation(bool enabled)
@@ -259,6 +787,15 @@ void TA_Tilemap::setUpdateAnimation(bool enabled)
     updateAnimation = enabled;
 }
 
+void TA_Tilemap::serialize(TA_StateBuffer &buffer)
+{
+    buffer.sync(animationClocks);
+    buffer.sync(updateAnimation);
+    if(buffer.isReading()) {
+        updateTileFrames();
+    }
+}
+
 std::vector<TA_Tilemap::Hitbox> TA_Tilemap::getSpikesHitboxVector(int type)
 {
     std::vector<Hitbox> hitboxes;
@@ -2,8 +2,11 @@
 #include <vector>
 #include <limits>
 #include <fstream>
+#include <cstdint>
+#include <cstring>
 #include "SDL3/SDL.h"
 #include "tools.h"
+#include "error.h"
 
 namespace TA
 {
@@ -12,9 +15,15 @@ namespace TA
 
     int screenWidth, screenHeight, scaleFactor;
     double elapsedTime;
+    long long tickCount = 0;
+    double interpolation = 1;
+    bool stepping = false;
+    bool headless = false;
+    int renderResetCount = 0;
 
     std::string levelPath = "", previousLevelPath = "";
     std::set<std::string> arguments;
+    std::map<std::string, std::string> argumentValues;
 
     namespace random
     {
@@ -25,11 +34,37 @@ namespace TA
     {
         std::ifstream input;
         std::ofstream output;
+        TA_InputState currentInput;
+        long long steps = 0;
+
+        // header: magic, version, seed; then a frame record per frame followed by a step record per step,
+        // frame records may be left out, such frames keep their own time (one step in headless mode)
+        const char magic[4] = {'T', 'A', 'E', 'L'};
+        const uint32_t version = 1;
+
+        enum RecordType : uint8_t {
+            RECORD_FRAME, // frame time
+            RECORD_STEP, // pressed, just pressed, direction
+            RECORD_STEP_NEUTRAL // pressed, just pressed
+        };
+
+        static_assert(TA_BUTTON_MAX <= 8, "buttons are logged as one byte");
+
+        template<typename T>
+        void write(T value) {output.write(reinterpret_cast<const char*>(&value), sizeof(value));}
+
+        template<typename T>
+        bool read(T &value) {return bool(input.read(reinterpret_cast<char*>(&value), sizeof(value)));}
+
+        bool finishReplay();
     }
 }
 
 void TA::drawRect(TA_Point topLeft, TA_Point bottomRight, int r, int g, int b, int a)
 {
+    if(TA::headless) {
+        return;
+    }
     SDL_FRect rect;
     rect.x = topLeft.x * TA::scaleFactor;
     rect.y = topLeft.y * TA::scaleFactor;
@@ -74,6 +109,16 @@ long long TA::random::max()
     return std::numeric_limits<long long>::max();
 }
 
+unsigned long long TA::random::getState()
+{
+    return x;
+}
+
+void TA::random::setState(unsigned long long state)
+{
+    x = state;
+}
+
 double TA::linearInterpolation(double left, double right, double pos)
 {
     pos = fmod(pos, 2);
@@ -82,3 +127,124 @@ double TA::linearInterpolation(double left, double right, double pos)
     }
     return right - (right - left) * (pos - 1);
 }
+
+unsigned long long TA::eventLog::init(unsigned long long seed)
+{
+    #ifdef __ANDROID__
+        // onscreen controls are read per screen, after the step is logged
+        if(arguments.count("--replay") || arguments.count("--record")) {
+            TA::handleError("%s", "--record and --replay are not supported with onscreen controls");
+        }
+    #endif
+
+    if(arguments.count("--replay")) {
+        if(!argumentValues.count("--replay")) {
+            TA::handleError("%s", "--replay needs a file name");
+        }
+        std::string filename = argumentValues["--replay"];
+        input.open(filename, std::ios::binary);
+
+        char fileMagic[4];
+        uint32_t fileVersion = 0;
+        uint64_t fileSeed = 0;
+        if(!input.read(fileMagic, sizeof(fileMagic)) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ||
+            !read(fileVersion) || fileVersion != version || !read(fileSeed)) {
+            TA::handleError("%s is not a valid input log", filename.c_str());
+        }
+        return fileSeed;
+    }
+
+    if(arguments.count("--record")) {
+        if(!argumentValues.count("--record")) {
+            TA::handleError("%s", "--record needs a file name");
+        }
+        std::string filename = argumentValues["--record"];
+        output.open(filename, std::ios::binary);
+        if(!output) {
+            TA::handleError("Failed to open %s for writing", filename.c_str());
+        }
+        output.write(magic, sizeof(magic));
+        write(version);
+        write(uint64_t(seed));
+    }
+    return seed;
+}
+
+bool TA::eventLog::isActive()
+{
+    return input.is_open() || output.is_open();
+}
+
+bool TA::eventLog::isReplaying()
+{
+    return input.is_open();
+}
+
+bool TA::eventLog::updateFrame(double &frameTime)
+{
+    if(output.is_open()) {
+        write(RECORD_FRAME);
+        write(frameTime);
+    }
+    else if(input.is_open()) {
+        if(input.peek() != RECORD_FRAME) {
+            return input.peek() != std::ifstream::traits_type::eof() || finishReplay();
+        }
+        RecordType type;
+        if(!read(type) || !read(frameTime)) {
+            return finishReplay();
+        }
+    }
+    return true;
+}
+
+bool TA::eventLog::updateStep(TA_InputState &state)
+{
+    if(output.is_open()) {
+        // the game gets what a replay will read back
+        float x = state.direction.x, y = state.direction.y;
+        state.direction = TA_Point(x, y);
+        bool neutral = (x == 0 && y == 0);
+        write(neutral ? RECORD_STEP_NEUTRAL : RECORD_STEP);
+        write(uint8_t(state.pressed));
+        write(uint8_t(state.justPressed));
+        if(!neutral) {
+            write(x);
+            write(y);
+        }
+    }
+    else if(input.is_open()) {
+        RecordType type;
+        uint8_t pressed, justPressed;
+        float x = 0, y = 0;
+        if(!read(type) || (type != RECORD_STEP && type != RECORD_STEP_NEUTRAL) || !read(pressed) || !read(justPressed) ||
+            (type == RECORD_STEP && (!read(x) || !read(y)))) {
+            return finishReplay();
+        }
+        state.direction = TA_Point(x, y);
+        state.pressed = pressed;
+        state.justPressed = justPressed;
+    }
+    currentInput = state;
+    steps ++;
+    return true;
+}
+
+bool TA::eventLog::finishReplay()
+{
+    TA::printLog("Replay finished after %lld steps", steps);
+    input.close();
+    currentInput = TA_InputState();
+    return false;
+}
+
+const TA_InputState &TA::eventLog::getInput()
+{
+    return currentInput;
+}
+
+void TA::eventLog::quit()
+{
+    input.close();
+    output.close();
+}
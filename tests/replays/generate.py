@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+# Writes the scripted input logs replayed by the replay-pf* tests, see TA::eventLog in src/tools.cpp.
+# The logs have no frame records, so every frame is one step in headless mode.
+# Each one picks its level in the dev menu (--devmenu) and runs right with jumps and short turns.
+
+import struct
+import sys
+from pathlib import Path
+
+RECORD_STEP, RECORD_STEP_NEUTRAL = 1, 2
+BUTTON_A = 1 << 0
+
+
+def write_log(path, level_index, steps=3600):
+    records = []
+
+    def step(direction=(0, 0), pressed=0, just_pressed=0):
+        if direction == (0, 0):
+            records.append(struct.pack("<BBB", RECORD_STEP_NEUTRAL, pressed, just_pressed))
+        else:
+            records.append(struct.pack("<BBBff", RECORD_STEP, pressed, just_pressed, *direction))
+
+    for _ in range(10):
+        step()
+    for _ in range(level_index):
+        step((1, 0))
+        step()
+    step(pressed=BUTTON_A, just_pressed=BUTTON_A)
+    for _ in range(180):
+        step()
+
+    for tick in range(steps):
+        phase = tick % 240
+        direction = (-1, 0) if phase >= 200 else (1, 0)
+        jump = 40 <= phase < 65 or 140 <= phase < 150
+        just_jumped = phase in (40, 140)
+        step(direction, BUTTON_A if jump else 0, BUTTON_A if just_jumped else 0)
+
+    with open(path, "wb") as output:
+        output.write(b"TAEL" + struct.pack("<IQ", 1, 1))
+        output.write(b"".join(records))
+
+
+if __name__ == "__main__":
+    directory = Path(sys.argv[1] if len(sys.argv) > 1 else Path(__file__).parent)
+    for index, level in enumerate(["pf1", "pf2", "pf3"]):
+        write_log(directory / (level + ".tael"), index)
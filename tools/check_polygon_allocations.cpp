@@ -0,0 +1,67 @@
+// Checks that TA_Polygon never allocates, runs the operations of a TA_Pawn collision probe
+// with operator new counting calls; exits with 1 if any of them touched the heap
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "geometry.h"
+
+namespace {
+    size_t allocationCount = 0;
+}
+
+void* operator new(size_t size)
+{
+    allocationCount ++;
+    if(void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+int main()
+{
+    // a sloped tile hitbox, built the way the tilemap loader does it
+    TA_Polygon slope;
+    slope.addVertex({0, 16});
+    slope.addVertex({16, 0});
+    slope.addVertex({16, 16});
+    slope.setPosition({32, 48});
+
+    TA_Polygon block({0, 0}, {16, 16});
+    block.setPosition({64, 48});
+
+    const size_t before = allocationCount;
+    int hits = 0;
+    for(int probe = 0; probe < 1000; probe ++) {
+        // a probe copies the pawn hitbox, moves it and tests it against the candidates
+        TA_Polygon hitbox({0, 0}, {16, 24});
+        TA_Polygon moved = hitbox;
+        moved.setPosition({20 + probe * 0.05, 30});
+        TA_Point mtv;
+        hits += moved.intersects(slope) + moved.intersects(block);
+        hits += moved.getPenetration(slope, mtv);
+        hits += slope.inside(moved.getBottomRight());
+
+        TA_Polygon triangle;
+        triangle.addVertex({0, 0});
+        triangle.addVertex({8, 8});
+        triangle.addVertex({0, 8});
+        triangle.setPosition(moved.getPosition());
+        hits += triangle.intersects(block);
+    }
+    const size_t allocations = allocationCount - before;
+
+    std::printf("%zu allocations in 1000 probes (%i hits)\n", allocations, hits);
+    return allocations == 0 ? 0 : 1;
+}
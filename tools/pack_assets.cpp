@@ -0,0 +1,74 @@
+// Packs the assets directory into one file for TA::assetPack, see include/asset_pack.h
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "asset_pack.h"
+
+int main(int argc, char* argv[])
+{
+    if(argc != 3) {
+        std::fprintf(stderr, "Usage: %s <assets directory> <output file>\n", argv[0]);
+        return 1;
+    }
+
+    std::filesystem::path assetsPath = argv[1];
+    std::vector<std::string> names;
+    for(const std::filesystem::directory_entry &entry : std::filesystem::recursive_directory_iterator(assetsPath)) {
+        if(entry.is_regular_file()) {
+            names.push_back(std::filesystem::relative(entry.path(), assetsPath).generic_string());
+        }
+    }
+    std::sort(names.begin(), names.end());
+
+    auto align = [](uint64_t offset) {
+        return (offset + TA::assetPack::dataAlignment - 1) / TA::assetPack::dataAlignment * TA::assetPack::dataAlignment;
+    };
+
+    TA_AssetPackHeader header{};
+    std::memcpy(header.magic, TA::assetPack::magic, sizeof(header.magic));
+    header.version = TA::assetPack::version;
+    header.count = names.size();
+
+    std::vector<TA_AssetPackEntry> entries(names.size());
+    uint64_t offset = sizeof(header) + entries.size() * sizeof(TA_AssetPackEntry);
+    for(size_t pos = 0; pos < names.size(); pos ++) {
+        entries[pos].nameOffset = offset;
+        entries[pos].nameLength = names[pos].size();
+        offset += names[pos].size();
+    }
+    for(size_t pos = 0; pos < names.size(); pos ++) {
+        offset = align(offset);
+        entries[pos].dataOffset = offset;
+        entries[pos].dataSize = std::filesystem::file_size(assetsPath / names[pos]);
+        offset += entries[pos].dataSize;
+    }
+
+    std::ofstream output(argv[2], std::ios::binary);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(TA_AssetPackEntry));
+    for(const std::string &name : names) {
+        output.write(name.data(), name.size());
+    }
+    for(size_t pos = 0; pos < names.size(); pos ++) {
+        while(uint64_t(output.tellp()) < entries[pos].dataOffset) {
+            output.put('\0');
+        }
+        if(entries[pos].dataSize != 0) {
+            std::ifstream input(assetsPath / names[pos], std::ios::binary);
+            output << input.rdbuf();
+        }
+    }
+
+    if(!output) {
+        std::fprintf(stderr, "Failed to write %s\n", argv[2]);
+        return 1;
+    }
+    std::printf("Packed %zu assets into %s (%llu bytes)\n", names.size(), argv[2], (unsigned long long)offset);
+    return 0;
+}